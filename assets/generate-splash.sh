@@ -9,6 +9,8 @@ SCRIPT_DIR=$(dirname "$0")
 SOURCE_DIR="${SCRIPT_DIR}/source"
 OUTPUT_DIR="${SCRIPT_DIR}/generated"
 LOGO="${SOURCE_DIR}/ghostbsd-logo.png"
+MKPROGRESSIVE="${OUTPUT_DIR}/mkprogressive"
+PROGRESSIVE_PASSES=5
 BACKGROUND_COLOR="#0b1220"
 
 # Common resolutions
@@ -39,6 +41,14 @@ check_dependencies() {
     if ! command -v convert >/dev/null 2>&1; then
         error "ImageMagick not found. Install with: pkg install ImageMagick7"
     fi
+    if ! command -v cc >/dev/null 2>&1; then
+        error "C compiler not found (needed for mkprogressive)"
+    fi
+}
+
+build_mkprogressive() {
+    info "Building mkprogressive..."
+    cc -O2 -o "${MKPROGRESSIVE}" "${SCRIPT_DIR}/mkprogressive.c"
 }
 
 create_output_dir() {
@@ -66,6 +76,10 @@ generate_splash() {
     else
         error "Failed to generate valid BMP: ${output}"
     fi
+    
+    # Coarse-to-fine copy for fast first paint on slow ESP media
+    "${MKPROGRESSIVE}" -p "${PROGRESSIVE_PASSES}" "${output}" "${output%.bmp}.pgs"
+    echo "    ✓ ${output%.bmp}.pgs"
 }
 
 generate_all() {
@@ -96,6 +110,7 @@ show_info() {
 main() {
     check_dependencies
     create_output_dir
+    build_mkprogressive
     generate_all
     show_info
     
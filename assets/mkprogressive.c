@@ -0,0 +1,155 @@
+/*
+ * Convert a 24-bit uncompressed BMP into the progressive splash format
+ * read by efi/src/progressive.c (see efi/include/progressive.h).
+ *
+ * Usage: mkprogressive [-p passes] input.bmp output.pgs
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROGRESSIVE_SIGNATURE   0x50535047  /* "GPSP" */
+#define PROGRESSIVE_VERSION     1
+#define PROGRESSIVE_MAX_PASSES  6
+#define HEADER_SIZE             20
+
+static uint32_t
+get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t
+get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void
+put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+static void
+put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr, "usage: mkprogressive [-p passes] input.bmp output.pgs\n");
+    exit(1);
+}
+
+int
+main(int argc, char *argv[])
+{
+    FILE *in, *out;
+    uint8_t fh[14], ih[40], hdr[HEADER_SIZE];
+    uint8_t *pixels;
+    int32_t width, height;
+    uint32_t w, h, row_size, off_bits, step;
+    int passes = 5, top_down, ch;
+    size_t data_size;
+
+    while ((ch = getopt(argc, argv, "p:")) != -1) {
+        switch (ch) {
+        case 'p':
+            passes = atoi(optarg);
+            if (passes < 1 || passes > PROGRESSIVE_MAX_PASSES)
+                usage();
+            break;
+        default:
+            usage();
+        }
+    }
+    argc -= optind;
+    argv += optind;
+    if (argc != 2)
+        usage();
+
+    if ((in = fopen(argv[0], "rb")) == NULL) {
+        perror(argv[0]);
+        return 1;
+    }
+    if (fread(fh, sizeof(fh), 1, in) != 1 ||
+        fread(ih, sizeof(ih), 1, in) != 1 ||
+        fh[0] != 'B' || fh[1] != 'M') {
+        fprintf(stderr, "%s: not a BMP file\n", argv[0]);
+        return 1;
+    }
+
+    off_bits = get_le32(fh + 10);
+    width = (int32_t)get_le32(ih + 4);
+    height = (int32_t)get_le32(ih + 8);
+    if (get_le16(ih + 14) != 24 || get_le32(ih + 16) != 0 ||
+        width <= 0 || height == 0 || width > 8192 ||
+        height > 8192 || height < -8192) {
+        fprintf(stderr, "%s: need 24-bit uncompressed BMP\n", argv[0]);
+        return 1;
+    }
+
+    top_down = height < 0;
+    w = (uint32_t)width;
+    h = (uint32_t)(top_down ? -height : height);
+    row_size = ((w * 3 + 3) / 4) * 4;
+    data_size = (size_t)row_size * h;
+
+    if ((pixels = malloc(data_size)) == NULL) {
+        perror("malloc");
+        return 1;
+    }
+    if (fseek(in, off_bits, SEEK_SET) != 0 ||
+        fread(pixels, data_size, 1, in) != 1) {
+        fprintf(stderr, "%s: truncated pixel data\n", argv[0]);
+        return 1;
+    }
+    fclose(in);
+
+    if ((out = fopen(argv[1], "wb")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    memset(hdr, 0, sizeof(hdr));
+    put_le32(hdr + 0, PROGRESSIVE_SIGNATURE);
+    put_le16(hdr + 4, PROGRESSIVE_VERSION);
+    put_le16(hdr + 6, HEADER_SIZE);
+    put_le32(hdr + 8, w);
+    put_le32(hdr + 12, h);
+    hdr[16] = (uint8_t)passes;
+    fwrite(hdr, sizeof(hdr), 1, out);
+
+    /* Same sample order as ReadProgressivePass() */
+    for (int pass = 0; pass < passes; pass++) {
+        step = 1U << (passes - 1 - pass);
+        for (uint32_t y = 0; y < h; y += step) {
+            int coarse = pass > 0 && (y % (step * 2)) == 0;
+            uint32_t x = coarse ? step : 0;
+            uint32_t advance = coarse ? step * 2 : step;
+            const uint8_t *row = pixels +
+                (size_t)(top_down ? y : h - 1 - y) * row_size;
+
+            for (; x < w; x += advance)
+                fwrite(row + (size_t)x * 3, 3, 1, out);
+        }
+    }
+
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    free(pixels);
+    return 0;
+}
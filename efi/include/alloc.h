@@ -0,0 +1,38 @@
+#ifndef _ALLOC_H_
+#define _ALLOC_H_
+
+#include <efi.h>
+#include <efilib.h>
+
+// Allocation statistics for the splash pipeline
+typedef struct {
+    UINTN CurrentBytes;     // Bytes live right now
+    UINTN PeakBytes;        // High-water mark of CurrentBytes + RetainedBytes
+    UINTN AllocationCount;  // Successful allocations since start
+    UINTN OutstandingCount; // Allocations not yet freed
+    UINTN RetainedBytes;    // Handed to the OS and never freed
+} ALLOC_STATS;
+
+// AllocatePool wrapper that records size and a call-site tag
+VOID *TrackedAllocatePool(UINTN Size, CHAR16 *Tag);
+
+// FreePool counterpart for TrackedAllocatePool (NULL is ignored)
+void TrackedFreePool(VOID *Buffer);
+
+// AllocatePool for buffers that outlive the application (e.g. the BGRT
+// image); counted in RetainedBytes and the peak, not in the live list
+VOID *RetainedAllocatePool(EFI_MEMORY_TYPE PoolType, UINTN Size);
+
+// Undo RetainedAllocatePool for a buffer that was never handed over
+void FreeRetainedPool(VOID *Buffer, UINTN Size);
+
+// Snapshot current counters
+void GetAllocStats(ALLOC_STATS *Stats);
+
+// Print counters (debug)
+void DisplayAllocStats(void);
+
+// Print every allocation still live, returns how many were found
+UINTN ReportOutstandingAllocations(void);
+
+#endif // _ALLOC_H_
@@ -0,0 +1,77 @@
+#ifndef _BGRT_H_
+#define _BGRT_H_
+
+#include <efi.h>
+#include <efilib.h>
+#include "bmp.h"
+
+// ACPI structures (ACPI 6.x, section 5.2)
+#pragma pack(push, 1)
+
+typedef struct {
+    CHAR8  Signature[8];    // "RSD PTR "
+    UINT8  Checksum;
+    CHAR8  OemId[6];
+    UINT8  Revision;        // 2+ has XsdtAddress
+    UINT32 RsdtAddress;
+    UINT32 Length;
+    UINT64 XsdtAddress;
+    UINT8  ExtendedChecksum;
+    UINT8  Reserved[3];
+} ACPI_RSDP;
+
+typedef struct {
+    CHAR8  Signature[4];
+    UINT32 Length;
+    UINT8  Revision;
+    UINT8  Checksum;
+    CHAR8  OemId[6];
+    CHAR8  OemTableId[8];
+    UINT32 OemRevision;
+    UINT32 CreatorId;
+    UINT32 CreatorRevision;
+} ACPI_SDT_HEADER;
+
+// Boot Graphics Resource Table
+typedef struct {
+    ACPI_SDT_HEADER Header;     // "BGRT"
+    UINT16 Version;             // 1
+    UINT8  Status;              // Bit 0: displayed, bits 1-2: orientation
+    UINT8  ImageType;           // 0 = bitmap
+    UINT64 ImageAddress;        // BMP in EfiBootServicesData
+    UINT32 ImageOffsetX;
+    UINT32 ImageOffsetY;
+} ACPI_BGRT;
+
+#pragma pack(pop)
+
+#define BGRT_STATUS_DISPLAYED       0x01
+#define BGRT_STATUS_ORIENTATION     0x06
+#define BGRT_IMAGE_TYPE_BITMAP      0
+
+// Firmware logo still on screen, in screen coordinates
+typedef struct {
+    UINT32 X;
+    UINT32 Y;
+    UINT32 Width;
+    UINT32 Height;
+} BGRT_LOGO;
+
+// Find the BGRT through the ACPI entries in the system configuration table
+EFI_STATUS FindBGRT(ACPI_BGRT **Bgrt);
+
+// Describe the logo firmware drew, if it is displayed and unrotated
+EFI_STATUS GetBGRTLogo(ACPI_BGRT *Bgrt, BGRT_LOGO *Logo);
+
+// Point the BGRT at a copy of our splash so later stages redraw it
+EFI_STATUS UpdateBGRT(
+    ACPI_BGRT *Bgrt,
+    SPLASH_IMAGE *Image,
+    UINT32 OffsetX,
+    UINT32 OffsetY
+);
+
+// Clear the displayed bit once the image is no longer on screen
+void WithdrawBGRT(ACPI_BGRT *Bgrt);
+
+#endif // _BGRT_H_
@@ -21,7 +21,7 @@ typedef struct {
     INT32  Height;          // Image height
     UINT16 Planes;          // Must be 1
     UINT16 BitCount;        // Bits per pixel (24 or 32)
-    UINT32 Compression;     // 0 = uncompressed
+    UINT32 Compression;     // 0 = uncompressed, 3 = bitfields (32-bit)
     UINT32 SizeImage;       // Image size (can be 0 for uncompressed)
     INT32  XPelsPerMeter;   // Horizontal resolution
     INT32  YPelsPerMeter;   // Vertical resolution
@@ -29,8 +29,37 @@ typedef struct {
     UINT32 ClrImportant;    // Important colors
 } BMP_INFO_HEADER;
 
+// Channel masks following the info header (BI_BITFIELDS / V4 / V5)
+typedef struct {
+    UINT32 RedMask;
+    UINT32 GreenMask;
+    UINT32 BlueMask;
+    UINT32 AlphaMask;       // Only present when header Size >= 56
+} BMP_BITFIELDS;
+
 #pragma pack(pop)
 
+#define BMP_COMPRESSION_RGB         0
+#define BMP_COMPRESSION_BITFIELDS   3
+
+// Decoded image in GOP BLT layout (top-down, Width * Height pixels)
+typedef struct {
+    UINT32 Width;
+    UINT32 Height;
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Pixels;
+    BOOLEAN HasAlpha;       // Reserved holds straight alpha (0 = transparent)
+} SPLASH_IMAGE;
+
+// Clockwise rotation applied while converting to BLT layout
+typedef enum {
+    SplashRotate0,
+    SplashRotate90,
+    SplashRotate180,
+    SplashRotate270,
+    SplashRotateCount,
+    SplashRotateAuto = SplashRotateCount    // Pick per display from aspect ratio
+} SPLASH_ROTATION;
+
 // Function declarations
 
 // Load BMP file from filesystem
@@ -42,12 +71,38 @@ EFI_STATUS LoadBMPFromFile(
 );
 
 // Display BMP on screen using GOP
+// ClearScreen = FALSE keeps whatever firmware already drew
 EFI_STATUS DisplayBMP(
     EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
     UINT8 *BmpData,
-    UINTN BmpSize
+    UINTN BmpSize,
+    BOOLEAN ClearScreen
+);
+
+// Decode BMP into a BLT buffer that can be blitted to any display
+EFI_STATUS DecodeBMP(
+    UINT8 *BmpData,
+    UINTN BmpSize,
+    SPLASH_IMAGE *Image
 );
 
+// Decode BMP and rotate it in the same pass (no intermediate buffer)
+EFI_STATUS DecodeBMPRotated(
+    UINT8 *BmpData,
+    UINTN BmpSize,
+    SPLASH_ROTATION Rotation,
+    SPLASH_IMAGE *Image
+);
+
+// Release pixels owned by a decoded image
+void FreeSplashImage(SPLASH_IMAGE *Image);
+
+// Size of the 24-bit BMP file EncodeBMP writes for an image
+UINTN GetEncodedBMPSize(SPLASH_IMAGE *Image);
+
+// Write a decoded image as a 24-bit bottom-up BMP into Buffer
+EFI_STATUS EncodeBMP(SPLASH_IMAGE *Image, UINT8 *Buffer, UINTN BufferSize);
+
 // Validate BMP format
 BOOLEAN ValidateBMP(UINT8 *BmpData, UINTN BmpSize);
 
@@ -0,0 +1,89 @@
+#ifndef _DISPLAY_H_
+#define _DISPLAY_H_
+
+#include <efi.h>
+#include <efilib.h>
+#include "bmp.h"
+
+// Upper bound on heads we drive; extra GOP handles are ignored
+#define MAX_SPLASH_DISPLAYS 8
+
+// Rotation used by SplashRotateAuto when image and mode orientation differ
+// (landscape image on a portrait mode or the reverse)
+#ifndef SPLASH_AUTO_ROTATION
+#define SPLASH_AUTO_ROTATION SplashRotate90
+#endif
+
+// Per-display placement, computed once before any pixels are drawn
+typedef struct {
+    EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop;
+    BOOLEAN Console;        // Head the firmware console (and its logo) is on
+    UINT32 ScreenWidth;
+    UINT32 ScreenHeight;
+    SPLASH_ROTATION Rotation; // Applied while converting the image
+    UINT32 DrawWidth;       // Image size on this display after rotation and scaling
+    UINT32 DrawHeight;
+    UINT32 OffsetX;         // Top-left corner of the centered image
+    UINT32 OffsetY;
+    BOOLEAN Scaled;         // DrawWidth/DrawHeight differ from the image
+    SPLASH_IMAGE *Cache;    // Scaled copy shared with same-resolution heads
+    BOOLEAN OwnsCache;      // This entry frees Cache
+    BOOLEAN Preserve;       // Leave the Preserve* rectangle untouched
+    UINT32 PreserveX;
+    UINT32 PreserveY;
+    UINT32 PreserveWidth;
+    UINT32 PreserveHeight;
+} SPLASH_DISPLAY;
+
+// Enumerate every GOP-capable display. The head the firmware console is
+// on (where it drew its logo) is returned first with Console set; when no
+// head can be identified none has it.
+EFI_STATUS LocateDisplays(
+    SPLASH_DISPLAY *Displays,
+    UINTN MaxDisplays,
+    UINTN *Count
+);
+
+// Compute rotation, scale and offset for each display against an
+// unrotated Width x Height image. Rotation may be SplashRotateAuto.
+void PlanDisplays(
+    SPLASH_DISPLAY *Displays,
+    UINTN Count,
+    UINT32 Width,
+    UINT32 Height,
+    SPLASH_ROTATION Rotation
+);
+
+// TRUE if any planned display needs the image at this rotation
+BOOLEAN DisplaysUseRotation(
+    SPLASH_DISPLAY *Displays,
+    UINTN Count,
+    SPLASH_ROTATION Rotation
+);
+
+// Keep an on-screen rectangle (e.g. the firmware logo) out of opaque blits
+// and leave the display uncleared; FALSE if it does not fit the display
+BOOLEAN PreserveRegion(
+    SPLASH_DISPLAY *Display,
+    UINT32 X,
+    UINT32 Y,
+    UINT32 Width,
+    UINT32 Height
+);
+
+// Clear every display to black, except those with a preserved region
+EFI_STATUS ClearDisplays(SPLASH_DISPLAY *Displays, UINTN Count);
+
+// Blit the decoded image to every display (does not clear first)
+// Images holds one entry per SPLASH_ROTATION; each display uses its own
+// Returns EFI_SUCCESS if at least one display was drawn
+EFI_STATUS RenderToDisplays(
+    SPLASH_DISPLAY *Displays,
+    UINTN Count,
+    SPLASH_IMAGE *Images
+);
+
+// Release any scaled copies created by RenderToDisplays
+void ReleaseDisplays(SPLASH_DISPLAY *Displays, UINTN Count);
+
+#endif // _DISPLAY_H_
@@ -0,0 +1,69 @@
+#ifndef _PROGRESSIVE_H_
+#define _PROGRESSIVE_H_
+
+#include <efi.h>
+#include <efilib.h>
+#include "bmp.h"
+
+// Progressive splash: coarse-to-fine interleaved passes so a preview can
+// be painted from the first few KB of the file.
+//
+// Pass 0 stores every Step-th pixel of every Step-th row, with
+// Step = 1 << (PassCount - 1). Each following pass halves Step and stores
+// only the samples not already sent. The last pass has Step 1.
+// Samples are 3 bytes (B, G, R) in raster order within a pass, no padding.
+
+#define PROGRESSIVE_SIGNATURE   0x50535047  // "GPSP"
+#define PROGRESSIVE_VERSION     1
+#define PROGRESSIVE_MAX_PASSES  6           // Coarsest grid 32x32
+
+#pragma pack(push, 1)
+
+typedef struct {
+    UINT32 Signature;
+    UINT16 Version;
+    UINT16 HeaderSize;      // Offset to pass 0
+    UINT32 Width;
+    UINT32 Height;
+    UINT8  PassCount;
+    UINT8  Reserved[3];
+} PROGRESSIVE_HEADER;
+
+#pragma pack(pop)
+
+// Streaming reader state
+typedef struct {
+    EFI_FILE_PROTOCOL *File;
+    UINT32 Width;           // Unrotated size from the header
+    UINT32 Height;
+    SPLASH_IMAGE Images[SplashRotateCount]; // Requested orientations, refined
+                                            // in place after every pass
+    UINT32 PassCount;
+    UINT32 Pass;            // Next pass to read
+    UINT8 *Chunk;           // Read-ahead buffer
+    UINTN ChunkLength;
+    UINTN ChunkPosition;
+} PROGRESSIVE_READER;
+
+// Open a progressive file and validate its header
+EFI_STATUS OpenProgressive(
+    EFI_FILE_PROTOCOL *Root,
+    CHAR16 *FileName,
+    PROGRESSIVE_READER *Reader
+);
+
+// Allocate Reader->Images[Rotation]; passes are written into it already
+// rotated, so no rotated copy is made. Call before the first pass.
+EFI_STATUS AddProgressiveRotation(
+    PROGRESSIVE_READER *Reader,
+    SPLASH_ROTATION Rotation
+);
+
+// Read the next pass and refine every image in Reader->Images
+// Returns EFI_END_OF_FILE once every pass has been read
+EFI_STATUS ReadProgressivePass(PROGRESSIVE_READER *Reader);
+
+// Close the file and release the images
+void CloseProgressive(PROGRESSIVE_READER *Reader);
+
+#endif // _PROGRESSIVE_H_
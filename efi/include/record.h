@@ -0,0 +1,65 @@
+#ifndef _RECORD_H_
+#define _RECORD_H_
+
+#include <efi.h>
+#include <efilib.h>
+#include "alloc.h"
+
+// EFI variable holding the boot record, readable from the OS via efivar
+#define BOOT_RECORD_VARIABLE L"GhostBSDSplashRecord"
+
+#define BOOT_RECORD_GUID \
+    { 0x6a3c1d52, 0x9e47, 0x4b0f, { 0x8d, 0x21, 0x57, 0xc4, 0x1e, 0xa9, 0x30, 0x6b } }
+
+#define BOOT_RECORD_VERSION 1
+
+// Fixed little-endian layout; append fields and bump the version
+#pragma pack(push, 1)
+
+typedef struct {
+    UINT32 Version;
+    UINT32 Size;                // sizeof(BOOT_RECORD)
+    UINT64 MemPeakBytes;
+    UINT64 MemOutstandingBytes; // Still allocated at handoff
+    UINT64 MemRetainedBytes;    // Left allocated for the OS (BGRT image)
+    UINT32 MemAllocationCount;
+    UINT32 MemOutstandingCount;
+    // Primary display, for asset tuning from the OS
+    UINT32 DisplayCount;
+    UINT32 DisplayWidth;        // Active GOP mode
+    UINT32 DisplayHeight;
+    UINT32 PixelFormat;         // EFI_GRAPHICS_PIXEL_FORMAT
+    UINT32 RotationDegrees;     // Clockwise rotation applied to the splash
+    UINT32 RotationForced;      // Nonzero when the build fixes the rotation
+                                // (not Auto): assets must not be pre-rotated
+    UINT32 AutoRotationDegrees; // Turn Auto gives an image that does not
+                                // match the mode's orientation
+    UINT32 SplashDrawn;         // Nonzero once a splash reached the screen;
+                                // RotationDegrees is only valid then
+} BOOT_RECORD;
+
+#pragma pack(pop)
+
+// Reset record to an empty current-version layout
+void InitBootRecord(BOOT_RECORD *Record);
+
+// Copy allocation counters into the record
+void RecordAllocStats(BOOT_RECORD *Record, ALLOC_STATS *Stats);
+
+// Copy primary display details and the build's rotation settings into
+// the record
+void RecordDisplay(
+    BOOT_RECORD *Record,
+    UINTN DisplayCount,
+    EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
+    BOOLEAN RotationForced,
+    UINT32 AutoRotationDegrees
+);
+
+// Mark the splash as drawn on the primary display at RotationDegrees
+void RecordSplash(BOOT_RECORD *Record, UINT32 RotationDegrees);
+
+// Publish the record as a volatile, runtime-accessible variable
+EFI_STATUS SaveBootRecord(BOOT_RECORD *Record);
+
+#endif // _RECORD_H_
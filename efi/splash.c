@@ -1,18 +1,80 @@
 #include <efi.h>
 #include <efilib.h>
 #include "bmp.h"
+#include "display.h"
+#include "alloc.h"
+#include "record.h"
+#include "progressive.h"
+#include "bgrt.h"
 #include "input.h"
 #include "error.h"
 
 #define SPLASH_TIMEOUT_MS 2000
 #define BOOTLOADER_PATH L"\\EFI\\BOOT\\BOOTX64.EFI"
 #define SPLASH_IMAGE_PATH L"\\EFI\\GhostBSD\\splash.bmp"
+#define SPLASH_PROGRESSIVE_PATH L"\\EFI\\GhostBSD\\splash.pgs"
 #define VERSION_STRING L"GhostBSD Splash v1.0.0"
 
+// SplashRotate0/90/180/270, or SplashRotateAuto to turn the image when its
+// orientation differs from the display mode (see SPLASH_AUTO_ROTATION)
+#ifndef SPLASH_ROTATION_DEFAULT
+#define SPLASH_ROTATION_DEFAULT SplashRotateAuto
+#endif
+
+#define SPLASH_ROTATION_FORCED (SPLASH_ROTATION_DEFAULT != SplashRotateAuto)
+
 // Configuration flags
 static BOOLEAN gDebugMode = FALSE;
 static BOOLEAN gSkipOnKey = TRUE;
 
+// Published to the OS just before handoff
+static BOOT_RECORD gBootRecord;
+
+// Firmware boot logo; when it is on screen the console display is drawn
+// around it instead of being cleared first
+static ACPI_BGRT *gBgrt = NULL;
+
+// The BGRT now describes our splash as on screen
+static BOOLEAN gBgrtPublished = FALSE;
+
+// Release every per-rotation image
+static void FreeRotatedImages(SPLASH_IMAGE *Images) {
+    for (UINTN r = 0; r < SplashRotateCount; r++) {
+        FreeSplashImage(&Images[r]);
+    }
+}
+
+// Hand the splash to later stages through the BGRT. Offsets are only
+// meaningful on the console head, and the copy is read back from it so it
+// matches the screen (blended alpha, scaling, a preserved firmware logo).
+// Runs once every display is drawn; the image's pixels hold the copy.
+static void PublishSplash(SPLASH_IMAGE *Images, SPLASH_DISPLAY *Displays) {
+    EFI_STATUS Status;
+    SPLASH_DISPLAY *Console = &Displays[0];
+    SPLASH_IMAGE Screen;
+    
+    if (gBgrt == NULL || !Console->Console || Images[Console->Rotation].Pixels == NULL) {
+        return;
+    }
+    
+    // The drawn area is never larger than the image it was drawn from
+    Screen.Width = Console->DrawWidth;
+    Screen.Height = Console->DrawHeight;
+    Screen.Pixels = Images[Console->Rotation].Pixels;
+    Screen.HasAlpha = FALSE;
+    
+    Status = uefi_call_wrapper(Console->Gop->Blt, 10, Console->Gop, Screen.Pixels,
+                               EfiBltVideoToBltBuffer, Console->OffsetX, Console->OffsetY,
+                               0, 0, Screen.Width, Screen.Height, 0);
+    if (!EFI_ERROR(Status)) {
+        Status = UpdateBGRT(gBgrt, &Screen, Console->OffsetX, Console->OffsetY);
+    }
+    gBgrtPublished = !EFI_ERROR(Status);
+    if (gDebugMode) {
+        Print(L"  BGRT update: %s\n", StatusToString(Status));
+    }
+}
+
 EFI_STATUS ChainloadBootloader(EFI_HANDLE ImageHandle, CHAR16 *BootloaderPath) {
     EFI_STATUS Status;
     EFI_DEVICE_PATH_PROTOCOL *DevicePath;
@@ -76,16 +138,135 @@ EFI_STATUS TryMultipleBootloaders(EFI_HANDLE ImageHandle) {
     return EFI_NOT_FOUND;
 }
 
+// Paint a coarse preview from the first pass of the progressive image and
+// refine it in place as the remaining passes are read from disk.
+// Succeeds once at least one pass has reached the screen.
+static EFI_STATUS ShowProgressiveSplash(EFI_FILE_PROTOCOL *Root,
+                                        SPLASH_DISPLAY *Displays, UINTN DisplayCount) {
+    EFI_STATUS Status;
+    PROGRESSIVE_READER Reader;
+    UINTN PassesShown = 0;
+    
+    Status = OpenProgressive(Root, SPLASH_PROGRESSIVE_PATH, &Reader);
+    if (EFI_ERROR(Status)) {
+        return Status;
+    }
+    
+    PlanDisplays(Displays, DisplayCount, Reader.Width, Reader.Height,
+                 SPLASH_ROTATION_DEFAULT);
+    
+    // Each pass is written straight into every orientation in use
+    for (UINTN r = 0; r < SplashRotateCount && !EFI_ERROR(Status); r++) {
+        if (DisplaysUseRotation(Displays, DisplayCount, r)) {
+            Status = AddProgressiveRotation(&Reader, r);
+        }
+    }
+    if (EFI_ERROR(Status)) {
+        CloseProgressive(&Reader);
+        return Status;
+    }
+    
+    ClearDisplays(Displays, DisplayCount);
+    
+    while (!EFI_ERROR(Status = ReadProgressivePass(&Reader))) {
+        if (!EFI_ERROR(RenderToDisplays(Displays, DisplayCount, Reader.Images))) {
+            PassesShown++;
+        }
+        ReleaseDisplays(Displays, DisplayCount);
+    }
+    
+    if (gDebugMode) {
+        Print(L"  Progressive splash: %d of %d passes shown\n",
+              PassesShown, Reader.PassCount);
+        if (Status != EFI_END_OF_FILE) {
+            Print(L"  Pass %d failed: %s\n", Reader.Pass, StatusToString(Status));
+        }
+    }
+    
+    if (Status == EFI_END_OF_FILE && PassesShown > 0) {
+        PublishSplash(Reader.Images, Displays);
+    }
+    
+    CloseProgressive(&Reader);
+    
+    return PassesShown > 0 ? EFI_SUCCESS : Status;
+}
+
+// Load the whole BMP, decode once per orientation in use and blit the
+// shared buffers to every display
+static EFI_STATUS ShowBMPSplash(EFI_FILE_PROTOCOL *Root,
+                                SPLASH_DISPLAY *Displays, UINTN DisplayCount) {
+    EFI_STATUS Status;
+    SPLASH_IMAGE Images[SplashRotateCount];
+    UINT8 *BmpData = NULL;
+    UINTN BmpSize;
+    UINT32 Width, Height;
+    
+    Status = LoadBMPFromFile(Root, SPLASH_IMAGE_PATH, &BmpData, &BmpSize);
+    if (EFI_ERROR(Status)) {
+        if (gDebugMode) {
+            DisplayWarning(L"Splash Image Not Found", 
+                          L"Booting without splash screen");
+            Print(L"  Expected path: %s\n\n", SPLASH_IMAGE_PATH);
+            uefi_call_wrapper(BS->Stall, 1, 2000000);
+        }
+        return Status;
+    }
+    
+    ZeroMem(Images, sizeof(Images));
+    Status = GetBMPDimensions(BmpData, BmpSize, &Width, &Height);
+    if (!EFI_ERROR(Status)) {
+        PlanDisplays(Displays, DisplayCount, Width, Height, SPLASH_ROTATION_DEFAULT);
+        
+        // Rotation is fused into the BGR to BLT conversion
+        for (UINTN r = 0; r < SplashRotateCount && !EFI_ERROR(Status); r++) {
+            if (DisplaysUseRotation(Displays, DisplayCount, r)) {
+                Status = DecodeBMPRotated(BmpData, BmpSize, r, &Images[r]);
+            }
+        }
+    }
+    
+    if (!EFI_ERROR(Status)) {
+        ClearDisplays(Displays, DisplayCount);
+        Status = RenderToDisplays(Displays, DisplayCount, Images);
+        ReleaseDisplays(Displays, DisplayCount);
+        if (!EFI_ERROR(Status)) {
+            PublishSplash(Images, Displays);
+        }
+    } else if (Status == EFI_OUT_OF_RESOURCES) {
+        // No room for a shared buffer; let each head stream rows itself
+        EFI_STATUS HeadStatus;
+        for (UINTN i = 0; i < DisplayCount; i++) {
+            // DisplayBMP draws unrotated whatever was planned
+            Displays[i].Rotation = SplashRotate0;
+            HeadStatus = DisplayBMP(Displays[i].Gop, BmpData, BmpSize,
+                                    !Displays[i].Preserve);
+            if (i == 0 || !EFI_ERROR(HeadStatus)) {
+                Status = HeadStatus;
+            }
+        }
+    }
+    
+    if (EFI_ERROR(Status) && gDebugMode) {
+        DisplayError(L"Failed to Display Splash", 
+                    L"Invalid BMP format or display error", Status);
+    }
+    
+    FreeRotatedImages(Images);
+    TrackedFreePool(BmpData);
+    return Status;
+}
+
 EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable) {
     EFI_STATUS Status;
-    EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop = NULL;
+    SPLASH_DISPLAY Displays[MAX_SPLASH_DISPLAYS];
+    UINTN DisplayCount = 0;
     EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
     EFI_FILE_PROTOCOL *Root;
-    UINT8 *BmpData = NULL;
-    UINTN BmpSize;
     BOOLEAN SplashDisplayed = FALSE;
     
     InitializeLib(ImageHandle, SystemTable);
+    InitBootRecord(&gBootRecord);
     
     // Check for debug key (F8) held at boot
     EFI_INPUT_KEY Key;
@@ -96,9 +277,8 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
         Print(L"════════════════════════════════════════════════════\n\n");
     }
     
-    // Locate Graphics Output Protocol (CORRECTED)
-    Status = uefi_call_wrapper(BS->LocateProtocol, 3, &gEfiGraphicsOutputProtocolGuid, 
-                               NULL, (VOID **)&Gop);
+    // Locate every Graphics Output Protocol instance (one per head)
+    Status = LocateDisplays(Displays, MAX_SPLASH_DISPLAYS, &DisplayCount);
     if (EFI_ERROR(Status)) {
         if (gDebugMode) {
             DisplayWarning(L"Graphics Not Available", 
@@ -108,8 +288,27 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
         goto boot; // Skip splash, go straight to boot
     }
     
+    RecordDisplay(&gBootRecord, DisplayCount, Displays[0].Gop, SPLASH_ROTATION_FORCED,
+                  (UINT32)SPLASH_AUTO_ROTATION * 90);
+    
     if (gDebugMode) {
-        DisplayBootInfo(Gop);
+        Print(L"  Displays found: %d\n", DisplayCount);
+        for (UINTN i = 0; i < DisplayCount; i++) {
+            DisplayBootInfo(Displays[i].Gop);
+        }
+    }
+    
+    // Adopt the logo firmware already drew rather than blanking over it.
+    // It is only on the console head, which LocateDisplays puts first;
+    // if that head is unknown nothing is preserved.
+    BGRT_LOGO Logo;
+    if (Displays[0].Console &&
+        !EFI_ERROR(FindBGRT(&gBgrt)) && !EFI_ERROR(GetBGRTLogo(gBgrt, &Logo)) &&
+        PreserveRegion(&Displays[0], Logo.X, Logo.Y, Logo.Width, Logo.Height)) {
+        if (gDebugMode) {
+            Print(L"  Firmware logo: %dx%d at %d,%d\n",
+                  Logo.Width, Logo.Height, Logo.X, Logo.Y);
+        }
     }
     
     // Get filesystem access (CORRECTED)
@@ -144,34 +343,19 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
         goto boot;
     }
     
-    // Load and display splash image
-    Status = LoadBMPFromFile(Root, SPLASH_IMAGE_PATH, &BmpData, &BmpSize);
+    // Prefer the progressive image; fall back to the plain BMP
+    Status = ShowProgressiveSplash(Root, Displays, DisplayCount);
     if (EFI_ERROR(Status)) {
-        if (gDebugMode) {
-            DisplayWarning(L"Splash Image Not Found", 
-                          L"Booting without splash screen");
-            Print(L"  Expected path: %s\n\n", SPLASH_IMAGE_PATH);
-            uefi_call_wrapper(BS->Stall, 1, 2000000);
-        }
-        Root->Close(Root);
-        goto boot;
+        Status = ShowBMPSplash(Root, Displays, DisplayCount);
     }
+    Root->Close(Root);
     
-    // Display the splash
-    Status = DisplayBMP(Gop, BmpData, BmpSize);
     if (EFI_ERROR(Status)) {
-        if (gDebugMode) {
-            DisplayError(L"Failed to Display Splash", 
-                        L"Invalid BMP format or display error", Status);
-        }
-        FreePool(BmpData);
-        Root->Close(Root);
         goto boot;
     }
     
     SplashDisplayed = TRUE;
-    FreePool(BmpData);
-    Root->Close(Root);
+    RecordSplash(&gBootRecord, (UINT32)Displays[0].Rotation * 90);
     
     // Wait for timeout or key press
     if (gSkipOnKey) {
@@ -193,11 +377,34 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     }
     
 boot:
+    // A published BGRT tells the OS the splash is still on screen, so it is
+    // left there through handoff. Debug output draws over it instead.
+    if (gBgrtPublished && gDebugMode) {
+        WithdrawBGRT(gBgrt);
+        gBgrtPublished = FALSE;
+    }
+    
     // Clear screen before booting
-    if (SplashDisplayed || gDebugMode) {
+    if ((SplashDisplayed || gDebugMode) && !gBgrtPublished) {
         uefi_call_wrapper(ST->ConOut->ClearScreen, 1, ST->ConOut);
     }
     
+    // Every splash buffer should be released by now; report what isn't
+    ALLOC_STATS Stats;
+    GetAllocStats(&Stats);
+    if (gDebugMode) {
+        DisplayAllocStats();
+        if (ReportOutstandingAllocations() > 0) {
+            uefi_call_wrapper(BS->Stall, 1, 2000000);
+        }
+    }
+    
+    RecordAllocStats(&gBootRecord, &Stats);
+    Status = SaveBootRecord(&gBootRecord);
+    if (EFI_ERROR(Status) && gDebugMode) {
+        Print(L"  Boot record not saved: %s\n", StatusToString(Status));
+    }
+    
     // Try to chainload bootloader
     Status = TryMultipleBootloaders(ImageHandle);
     
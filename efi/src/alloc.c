@@ -0,0 +1,129 @@
+#include <efi.h>
+#include <efilib.h>
+#include "alloc.h"
+
+// Header placed in front of every tracked block; live blocks form a list
+// so anything still allocated at handoff can be reported by tag
+typedef struct _ALLOC_HEADER {
+    struct _ALLOC_HEADER *Next;
+    struct _ALLOC_HEADER *Prev;
+    UINTN Size;
+    CHAR16 *Tag;
+} ALLOC_HEADER;
+
+static ALLOC_HEADER *gLiveList = NULL;
+static ALLOC_STATS gStats = {0, 0, 0, 0, 0};
+
+static void UpdatePeak(void) {
+    if (gStats.CurrentBytes + gStats.RetainedBytes > gStats.PeakBytes) {
+        gStats.PeakBytes = gStats.CurrentBytes + gStats.RetainedBytes;
+    }
+}
+
+VOID *TrackedAllocatePool(UINTN Size, CHAR16 *Tag) {
+    ALLOC_HEADER *Header;
+    
+    if (Size > (UINTN)-1 - sizeof(ALLOC_HEADER)) {
+        return NULL;
+    }
+    
+    Header = AllocatePool(sizeof(ALLOC_HEADER) + Size);
+    if (Header == NULL) {
+        return NULL;
+    }
+    
+    Header->Size = Size;
+    Header->Tag = Tag;
+    Header->Prev = NULL;
+    Header->Next = gLiveList;
+    if (gLiveList != NULL) {
+        gLiveList->Prev = Header;
+    }
+    gLiveList = Header;
+    
+    gStats.CurrentBytes += Size;
+    gStats.AllocationCount++;
+    gStats.OutstandingCount++;
+    UpdatePeak();
+    
+    return Header + 1;
+}
+
+void TrackedFreePool(VOID *Buffer) {
+    ALLOC_HEADER *Header;
+    
+    if (Buffer == NULL) {
+        return;
+    }
+    
+    Header = (ALLOC_HEADER *)Buffer - 1;
+    
+    if (Header->Prev != NULL) {
+        Header->Prev->Next = Header->Next;
+    } else {
+        gLiveList = Header->Next;
+    }
+    if (Header->Next != NULL) {
+        Header->Next->Prev = Header->Prev;
+    }
+    
+    gStats.CurrentBytes -= Header->Size;
+    gStats.OutstandingCount--;
+    
+    FreePool(Header);
+}
+
+VOID *RetainedAllocatePool(EFI_MEMORY_TYPE PoolType, UINTN Size) {
+    EFI_STATUS Status;
+    VOID *Buffer;
+    
+    Status = uefi_call_wrapper(BS->AllocatePool, 3, PoolType, Size, &Buffer);
+    if (EFI_ERROR(Status)) {
+        return NULL;
+    }
+    
+    gStats.RetainedBytes += Size;
+    gStats.AllocationCount++;
+    UpdatePeak();
+    
+    return Buffer;
+}
+
+void FreeRetainedPool(VOID *Buffer, UINTN Size) {
+    if (Buffer == NULL) {
+        return;
+    }
+    
+    gStats.RetainedBytes -= Size;
+    uefi_call_wrapper(BS->FreePool, 1, Buffer);
+}
+
+void GetAllocStats(ALLOC_STATS *Stats) {
+    if (Stats != NULL) {
+        *Stats = gStats;
+    }
+}
+
+void DisplayAllocStats(void) {
+    Print(L"\n");
+    Print(L"  Memory Usage\n");
+    Print(L"  ════════════════════════════════════════\n");
+    Print(L"  Peak:        %ld bytes\n", gStats.PeakBytes);
+    Print(L"  Current:     %ld bytes\n", gStats.CurrentBytes);
+    Print(L"  Allocations: %ld\n", gStats.AllocationCount);
+    Print(L"  Outstanding: %ld\n", gStats.OutstandingCount);
+    Print(L"  Retained:    %ld bytes\n", gStats.RetainedBytes);
+    Print(L"  ════════════════════════════════════════\n\n");
+}
+
+UINTN ReportOutstandingAllocations(void) {
+    UINTN Count = 0;
+    
+    for (ALLOC_HEADER *Header = gLiveList; Header != NULL; Header = Header->Next) {
+        Print(L"  Leak: %s (%ld bytes)\n",
+              Header->Tag != NULL ? Header->Tag : L"untagged", Header->Size);
+        Count++;
+    }
+    
+    return Count;
+}
@@ -0,0 +1,171 @@
+#include <efi.h>
+#include <efilib.h>
+#include "bgrt.h"
+#include "alloc.h"
+
+// Recompute the byte checksum so the whole table sums to zero
+static void FixChecksum(ACPI_SDT_HEADER *Table) {
+    UINT8 *Bytes = (UINT8 *)Table;
+    UINT8 Sum = 0;
+    
+    Table->Checksum = 0;
+    for (UINT32 i = 0; i < Table->Length; i++) {
+        Sum += Bytes[i];
+    }
+    Table->Checksum = (UINT8)(0 - Sum);
+}
+
+static ACPI_SDT_HEADER *FindInRootTable(ACPI_SDT_HEADER *Root, UINTN EntrySize,
+                                        CONST VOID *Signature) {
+    UINTN Count;
+    UINT8 *Entries;
+    
+    if (Root == NULL || Root->Length < sizeof(ACPI_SDT_HEADER)) {
+        return NULL;
+    }
+    
+    Count = (Root->Length - sizeof(ACPI_SDT_HEADER)) / EntrySize;
+    Entries = (UINT8 *)(Root + 1);
+    
+    for (UINTN i = 0; i < Count; i++) {
+        ACPI_SDT_HEADER *Table;
+        
+        // XSDT entries are 64-bit, RSDT entries 32-bit; both may be unaligned
+        if (EntrySize == sizeof(UINT64)) {
+            UINT64 Address;
+            CopyMem(&Address, Entries + i * EntrySize, sizeof(Address));
+            Table = (ACPI_SDT_HEADER *)(UINTN)Address;
+        } else {
+            UINT32 Address;
+            CopyMem(&Address, Entries + i * EntrySize, sizeof(Address));
+            Table = (ACPI_SDT_HEADER *)(UINTN)Address;
+        }
+        
+        if (Table != NULL && CompareMem(Table->Signature, Signature, 4) == 0) {
+            return Table;
+        }
+    }
+    
+    return NULL;
+}
+
+EFI_STATUS FindBGRT(ACPI_BGRT **Bgrt) {
+    EFI_STATUS Status;
+    ACPI_RSDP *Rsdp = NULL;
+    ACPI_SDT_HEADER *Table = NULL;
+    
+    if (Bgrt == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    *Bgrt = NULL;
+    
+    // Prefer the ACPI 2.0+ RSDP, fall back to 1.0
+    Status = LibGetSystemConfigurationTable(&Acpi20TableGuid, (VOID **)&Rsdp);
+    if (EFI_ERROR(Status) || Rsdp == NULL) {
+        Status = LibGetSystemConfigurationTable(&AcpiTableGuid, (VOID **)&Rsdp);
+        if (EFI_ERROR(Status) || Rsdp == NULL) {
+            return EFI_NOT_FOUND;
+        }
+    }
+    
+    if (CompareMem(Rsdp->Signature, "RSD PTR ", 8) != 0) {
+        return EFI_NOT_FOUND;
+    }
+    
+    if (Rsdp->Revision >= 2 && Rsdp->XsdtAddress != 0) {
+        Table = FindInRootTable((ACPI_SDT_HEADER *)(UINTN)Rsdp->XsdtAddress,
+                                sizeof(UINT64), "BGRT");
+    }
+    if (Table == NULL && Rsdp->RsdtAddress != 0) {
+        Table = FindInRootTable((ACPI_SDT_HEADER *)(UINTN)Rsdp->RsdtAddress,
+                                sizeof(UINT32), "BGRT");
+    }
+    
+    if (Table == NULL || Table->Length < sizeof(ACPI_BGRT)) {
+        return EFI_NOT_FOUND;
+    }
+    
+    *Bgrt = (ACPI_BGRT *)Table;
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS GetBGRTLogo(ACPI_BGRT *Bgrt, BGRT_LOGO *Logo) {
+    UINT8 *LogoBmp;
+    BMP_FILE_HEADER *FileHeader;
+    EFI_STATUS Status;
+    
+    if (Bgrt == NULL || Logo == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    // A logo drawn rotated would need rotated coordinates; leave it alone
+    if (!(Bgrt->Status & BGRT_STATUS_DISPLAYED) ||
+        (Bgrt->Status & BGRT_STATUS_ORIENTATION) != 0 ||
+        Bgrt->ImageType != BGRT_IMAGE_TYPE_BITMAP ||
+        Bgrt->ImageAddress == 0) {
+        return EFI_NOT_FOUND;
+    }
+    
+    // Only the headers are needed for the logo's size
+    LogoBmp = (UINT8 *)(UINTN)Bgrt->ImageAddress;
+    FileHeader = (BMP_FILE_HEADER *)LogoBmp;
+    Status = GetBMPDimensions(LogoBmp, FileHeader->Size, &Logo->Width, &Logo->Height);
+    if (EFI_ERROR(Status)) {
+        // Logos may use depths we do not decode; trust the header fields
+        BMP_INFO_HEADER *InfoHeader = (BMP_INFO_HEADER *)(LogoBmp + sizeof(BMP_FILE_HEADER));
+        if (FileHeader->Type != 0x4D42 || InfoHeader->Width <= 0 || InfoHeader->Height == 0) {
+            return EFI_UNSUPPORTED;
+        }
+        Logo->Width = (UINT32)InfoHeader->Width;
+        Logo->Height = (UINT32)(InfoHeader->Height > 0 ? InfoHeader->Height : -InfoHeader->Height);
+    }
+    
+    Logo->X = Bgrt->ImageOffsetX;
+    Logo->Y = Bgrt->ImageOffsetY;
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS UpdateBGRT(ACPI_BGRT *Bgrt, SPLASH_IMAGE *Image,
+                      UINT32 OffsetX, UINT32 OffsetY) {
+    EFI_STATUS Status;
+    UINT8 *Buffer;
+    UINTN Size;
+    
+    if (Bgrt == NULL || Image == NULL || Image->Pixels == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    // The OS reads this after ExitBootServices, so it is never freed; it is
+    // still counted as retained memory. The ACPI spec places BGRT images in
+    // EfiBootServicesData.
+    Size = GetEncodedBMPSize(Image);
+    Buffer = RetainedAllocatePool(EfiBootServicesData, Size);
+    if (Buffer == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    Status = EncodeBMP(Image, Buffer, Size);
+    if (EFI_ERROR(Status)) {
+        FreeRetainedPool(Buffer, Size);
+        return Status;
+    }
+    
+    Bgrt->ImageType = BGRT_IMAGE_TYPE_BITMAP;
+    Bgrt->ImageAddress = (UINT64)(UINTN)Buffer;
+    Bgrt->ImageOffsetX = OffsetX;
+    Bgrt->ImageOffsetY = OffsetY;
+    Bgrt->Status = BGRT_STATUS_DISPLAYED;
+    FixChecksum(&Bgrt->Header);
+    
+    return EFI_SUCCESS;
+}
+
+void WithdrawBGRT(ACPI_BGRT *Bgrt) {
+    if (Bgrt == NULL) {
+        return;
+    }
+    
+    Bgrt->Status &= (UINT8)~BGRT_STATUS_DISPLAYED;
+    FixChecksum(&Bgrt->Header);
+}
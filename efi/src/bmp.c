@@ -1,6 +1,11 @@
 #include <efi.h>
 #include <efilib.h>
 #include "bmp.h"
+#include "alloc.h"
+
+static EFI_STATUS DisplayBMPRowByRow(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
+                                     UINT8 *BmpData, UINTN BmpSize,
+                                     INT32 OffsetX, INT32 OffsetY);
 
 EFI_STATUS LoadBMPFromFile(EFI_FILE_PROTOCOL *Root, CHAR16 *FileName, 
                            UINT8 **ImageData, UINTN *ImageSize) {
@@ -21,7 +26,7 @@ EFI_STATUS LoadBMPFromFile(EFI_FILE_PROTOCOL *Root, CHAR16 *FileName,
     }
     
     // Get file size
-    FileInfo = AllocatePool(BufferSize);
+    FileInfo = TrackedAllocatePool(BufferSize, L"FileInfo");
     if (FileInfo == NULL) {
         uefi_call_wrapper(File->Close, 1, File);
         return EFI_OUT_OF_RESOURCES;
@@ -31,15 +36,15 @@ EFI_STATUS LoadBMPFromFile(EFI_FILE_PROTOCOL *Root, CHAR16 *FileName,
                                &BufferSize, FileInfo);
     if (EFI_ERROR(Status)) {
         uefi_call_wrapper(File->Close, 1, File);
-        FreePool(FileInfo);
+        TrackedFreePool(FileInfo);
         return Status;
     }
     
     *ImageSize = FileInfo->FileSize;
-    FreePool(FileInfo);
+    TrackedFreePool(FileInfo);
     
     // Allocate buffer and read file
-    *ImageData = AllocatePool(*ImageSize);
+    *ImageData = TrackedAllocatePool(*ImageSize, L"BmpFile");
     if (*ImageData == NULL) {
         uefi_call_wrapper(File->Close, 1, File);
         return EFI_OUT_OF_RESOURCES;
@@ -49,14 +54,14 @@ EFI_STATUS LoadBMPFromFile(EFI_FILE_PROTOCOL *Root, CHAR16 *FileName,
     uefi_call_wrapper(File->Close, 1, File);
     
     if (EFI_ERROR(Status)) {
-        FreePool(*ImageData);
+        TrackedFreePool(*ImageData);
         *ImageData = NULL;
         return Status;
     }
     
     // Validate BMP
     if (!ValidateBMP(*ImageData, *ImageSize)) {
-        FreePool(*ImageData);
+        TrackedFreePool(*ImageData);
         *ImageData = NULL;
         return EFI_INVALID_PARAMETER;
     }
@@ -80,8 +85,25 @@ BOOLEAN ValidateBMP(UINT8 *BmpData, UINTN BmpSize) {
         return FALSE;
     }
     
-    // Check for supported formats (24-bit uncompressed)
-    if (InfoHeader->BitCount != 24 || InfoHeader->Compression != 0) {
+    // Check for supported formats (24-bit uncompressed, or 32-bit BGRA)
+    if (InfoHeader->BitCount == 24) {
+        if (InfoHeader->Compression != BMP_COMPRESSION_RGB) {
+            return FALSE;
+        }
+    } else if (InfoHeader->BitCount == 32) {
+        if (InfoHeader->Compression == BMP_COMPRESSION_BITFIELDS) {
+            BMP_BITFIELDS *Masks = (BMP_BITFIELDS *)(InfoHeader + 1);
+            
+            // Only the plain B, G, R byte order is supported
+            if (BmpSize < sizeof(BMP_FILE_HEADER) + sizeof(BMP_INFO_HEADER) + 12 ||
+                Masks->RedMask != 0x00FF0000 || Masks->GreenMask != 0x0000FF00 ||
+                Masks->BlueMask != 0x000000FF) {
+                return FALSE;
+            }
+        } else if (InfoHeader->Compression != BMP_COMPRESSION_RGB) {
+            return FALSE;
+        }
+    } else {
         return FALSE;
     }
     
@@ -113,20 +135,148 @@ EFI_STATUS GetBMPDimensions(UINT8 *BmpData, UINTN BmpSize,
     return EFI_SUCCESS;
 }
 
-// OPTIMIZED: Use buffer blitting instead of pixel-by-pixel
-EFI_STATUS DisplayBMP(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop, 
-                      UINT8 *BmpData, UINTN BmpSize) {
+// Alpha is only trusted when a V4/V5 header declares it; the fourth byte
+// of a plain 32-bit BI_RGB file is undefined and commonly zero
+static BOOLEAN BMPHasAlpha(UINT8 *BmpData, UINTN BmpSize) {
+    BMP_INFO_HEADER *InfoHeader = (BMP_INFO_HEADER *)(BmpData + sizeof(BMP_FILE_HEADER));
+    BMP_BITFIELDS *Masks = (BMP_BITFIELDS *)(InfoHeader + 1);
+    
+    return InfoHeader->BitCount == 32 &&
+           InfoHeader->Compression == BMP_COMPRESSION_BITFIELDS &&
+           InfoHeader->Size >= sizeof(BMP_INFO_HEADER) + sizeof(BMP_BITFIELDS) &&
+           BmpSize >= sizeof(BMP_FILE_HEADER) + sizeof(BMP_INFO_HEADER) + sizeof(BMP_BITFIELDS) &&
+           Masks->AlphaMask == 0xFF000000;
+}
+
+// Square tile edge for 90/270 degree conversion; 32x32 BLT pixels is 4KB,
+// so the rows being read and the columns being written both stay in cache
+#define ROTATE_TILE 32
+
+// Top-down view of B, G, R[, A] source pixels
+typedef struct {
+    UINT8 *Top;             // First screen row
+    INTN Stride;            // Bytes to the next row down (negative if bottom-up)
+    UINTN BytesPerPixel;
+    BOOLEAN HasAlpha;       // Fourth byte is alpha
+    UINT32 Width;
+    UINT32 Height;
+} PIXEL_SOURCE;
+
+// Convert and rotate source pixels into Dst in a single pass
+static void ConvertPixels(PIXEL_SOURCE *Source, SPLASH_ROTATION Rotation,
+                          EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Dst) {
+    UINT32 Width = Source->Width;
+    UINT32 Height = Source->Height;
+    UINTN Bpp = Source->BytesPerPixel;
+    BOOLEAN HasAlpha = Source->HasAlpha;
+    
+    if (Rotation != SplashRotate90 && Rotation != SplashRotate270) {
+        // 0 and 180 degrees keep rows intact: straight row-order walk
+        for (UINT32 y = 0; y < Height; y++) {
+            UINT8 *Src = Source->Top + (INTN)y * Source->Stride;
+            EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Out;
+            INTN Step = 1;
+            
+            if (Rotation == SplashRotate180) {
+                Out = Dst + (UINTN)(Height - 1 - y) * Width + (Width - 1);
+                Step = -1;
+            } else {
+                Out = Dst + (UINTN)y * Width;
+            }
+            
+            for (UINT32 x = 0; x < Width; x++) {
+                // Convert BGR to RGB
+                Out->Blue = Src[0];
+                Out->Green = Src[1];
+                Out->Red = Src[2];
+                Out->Reserved = HasAlpha ? Src[3] : 0;
+                Src += Bpp;
+                Out += Step;
+            }
+        }
+        return;
+    }
+    
+    // 90 and 270 degrees transpose: walk tile by tile so neither the source
+    // rows nor the destination columns thrash the cache
+    for (UINT32 TileY = 0; TileY < Height; TileY += ROTATE_TILE) {
+        UINT32 EndY = (Height - TileY < ROTATE_TILE) ? Height : TileY + ROTATE_TILE;
+        
+        for (UINT32 TileX = 0; TileX < Width; TileX += ROTATE_TILE) {
+            UINT32 EndX = (Width - TileX < ROTATE_TILE) ? Width : TileX + ROTATE_TILE;
+            
+            for (UINT32 y = TileY; y < EndY; y++) {
+                UINT8 *Src = Source->Top + (INTN)y * Source->Stride + TileX * Bpp;
+                EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Out;
+                INTN Step;
+                
+                // Output is Height pixels wide
+                if (Rotation == SplashRotate90) {
+                    // (x, y) -> (Height - 1 - y, x)
+                    Out = Dst + (UINTN)TileX * Height + (Height - 1 - y);
+                    Step = (INTN)Height;
+                } else {
+                    // (x, y) -> (y, Width - 1 - x)
+                    Out = Dst + (UINTN)(Width - 1 - TileX) * Height + y;
+                    Step = -(INTN)Height;
+                }
+                
+                for (UINT32 x = TileX; x < EndX; x++) {
+                    Out->Blue = Src[0];
+                    Out->Green = Src[1];
+                    Out->Red = Src[2];
+                    Out->Reserved = HasAlpha ? Src[3] : 0;
+                    Src += Bpp;
+                    Out += Step;
+                }
+            }
+        }
+    }
+}
+
+// Allocate an image sized for Source after Rotation and convert into it
+static EFI_STATUS ConvertToImage(PIXEL_SOURCE *Source, SPLASH_ROTATION Rotation,
+                                 CHAR16 *Tag, SPLASH_IMAGE *Image) {
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *BltBuffer;
+    BOOLEAN Transposed = (Rotation == SplashRotate90 || Rotation == SplashRotate270);
+    
+    if (Rotation >= SplashRotateCount) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    // Allocate buffer for entire image
+    BltBuffer = TrackedAllocatePool((UINTN)Source->Width * Source->Height *
+                                    sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL), Tag);
+    if (BltBuffer == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    ConvertPixels(Source, Rotation, BltBuffer);
+    
+    Image->Width = Transposed ? Source->Height : Source->Width;
+    Image->Height = Transposed ? Source->Width : Source->Height;
+    Image->Pixels = BltBuffer;
+    Image->HasAlpha = Source->HasAlpha;
+    
+    return EFI_SUCCESS;
+}
+
+// Convert BMP pixel data to BLT layout once; callers blit the result to
+// as many displays as they like without touching the file data again
+EFI_STATUS DecodeBMP(UINT8 *BmpData, UINTN BmpSize, SPLASH_IMAGE *Image) {
+    return DecodeBMPRotated(BmpData, BmpSize, SplashRotate0, Image);
+}
+
+EFI_STATUS DecodeBMPRotated(UINT8 *BmpData, UINTN BmpSize,
+                            SPLASH_ROTATION Rotation, SPLASH_IMAGE *Image) {
     BMP_FILE_HEADER *FileHeader;
     BMP_INFO_HEADER *InfoHeader;
     UINT8 *PixelData;
     INT32 Width, Height;
     UINTN RowSize;
-    UINT32 ScreenWidth, ScreenHeight;
-    INT32 OffsetX, OffsetY;
-    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *BltBuffer;
-    EFI_STATUS Status;
+    PIXEL_SOURCE Source;
     
-    if (Gop == NULL || BmpData == NULL) {
+    if (BmpData == NULL || Image == NULL) {
         return EFI_INVALID_PARAMETER;
     }
     
@@ -141,79 +291,104 @@ EFI_STATUS DisplayBMP(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
     Width = InfoHeader->Width;
     Height = InfoHeader->Height;
     
+    Source.BytesPerPixel = InfoHeader->BitCount / 8;
+    Source.HasAlpha = BMPHasAlpha(BmpData, BmpSize);
+    
     // BMP rows are padded to 4-byte boundaries
-    RowSize = ((Width * 3 + 3) / 4) * 4;
+    RowSize = ((Width * Source.BytesPerPixel + 3) / 4) * 4;
+    
+    // Determine if BMP is top-down or bottom-up
+    BOOLEAN TopDown = (Height < 0);
+    if (TopDown) {
+        Height = -Height;
+    }
+    
+    // Reject truncated files up front instead of checking every pixel
+    if (FileHeader->OffBits > BmpSize ||
+        RowSize * (UINTN)Height > BmpSize - FileHeader->OffBits) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    // Bottom-up files store the last screen row first
+    Source.Width = (UINT32)Width;
+    Source.Height = (UINT32)Height;
+    if (TopDown) {
+        Source.Top = PixelData;
+        Source.Stride = (INTN)RowSize;
+    } else {
+        Source.Top = PixelData + (UINTN)(Height - 1) * RowSize;
+        Source.Stride = -(INTN)RowSize;
+    }
+    
+    return ConvertToImage(&Source, Rotation, L"DecodedImage", Image);
+}
+
+void FreeSplashImage(SPLASH_IMAGE *Image) {
+    if (Image == NULL || Image->Pixels == NULL) {
+        return;
+    }
+    
+    TrackedFreePool(Image->Pixels);
+    Image->Pixels = NULL;
+}
+
+// OPTIMIZED: Use buffer blitting instead of pixel-by-pixel
+EFI_STATUS DisplayBMP(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop, 
+                      UINT8 *BmpData, UINTN BmpSize, BOOLEAN ClearScreen) {
+    UINT32 Width, Height;
+    UINT32 ScreenWidth, ScreenHeight;
+    INT32 OffsetX, OffsetY;
+    SPLASH_IMAGE Image;
+    EFI_STATUS Status;
+    
+    if (Gop == NULL || BmpData == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    Status = GetBMPDimensions(BmpData, BmpSize, &Width, &Height);
+    if (EFI_ERROR(Status)) {
+        return EFI_UNSUPPORTED;
+    }
     
     // Get screen dimensions
     ScreenWidth = Gop->Mode->Info->HorizontalResolution;
     ScreenHeight = Gop->Mode->Info->VerticalResolution;
     
     // Center the image on screen
-    OffsetX = (ScreenWidth - Width) / 2;
-    OffsetY = (ScreenHeight - Height) / 2;
+    OffsetX = ((INT32)ScreenWidth - (INT32)Width) / 2;
+    OffsetY = ((INT32)ScreenHeight - (INT32)Height) / 2;
     
     if (OffsetX < 0) OffsetX = 0;
     if (OffsetY < 0) OffsetY = 0;
     
     // Clear screen to black
-    EFI_GRAPHICS_OUTPUT_BLT_PIXEL Black = {0, 0, 0, 0};
-    Status = uefi_call_wrapper(Gop->Blt, 10, Gop, &Black, EfiBltVideoFill, 
-                               0, 0, 0, 0, 
-                               ScreenWidth, ScreenHeight, 0);
-    if (EFI_ERROR(Status)) {
-        return Status;
-    }
-    
-    // Determine if BMP is top-down or bottom-up
-    BOOLEAN TopDown = (Height < 0);
-    if (TopDown) {
-        Height = -Height;
+    if (ClearScreen) {
+        EFI_GRAPHICS_OUTPUT_BLT_PIXEL Black = {0, 0, 0, 0};
+        Status = uefi_call_wrapper(Gop->Blt, 10, Gop, &Black, EfiBltVideoFill, 
+                                   0, 0, 0, 0, 
+                                   ScreenWidth, ScreenHeight, 0);
+        if (EFI_ERROR(Status)) {
+            return Status;
+        }
     }
     
-    // Allocate buffer for entire image
-    BltBuffer = AllocatePool(Width * Height * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-    if (BltBuffer == NULL) {
+    Status = DecodeBMP(BmpData, BmpSize, &Image);
+    if (Status == EFI_OUT_OF_RESOURCES) {
         // Fall back to row-by-row rendering if we can't allocate full buffer
         return DisplayBMPRowByRow(Gop, BmpData, BmpSize, OffsetX, OffsetY);
     }
-    
-    // Convert BMP to BltBuffer format
-    for (INT32 y = 0; y < Height; y++) {
-        for (INT32 x = 0; x < Width; x++) {
-            UINTN BmpIndex;
-            UINTN BltIndex;
-            
-            if (TopDown) {
-                BmpIndex = y * RowSize + x * 3;
-                BltIndex = y * Width + x;
-            } else {
-                // Bottom-up: flip Y coordinate
-                BmpIndex = (Height - 1 - y) * RowSize + x * 3;
-                BltIndex = y * Width + x;
-            }
-            
-            // Bounds check
-            if (BmpIndex + 2 >= BmpSize - FileHeader->OffBits) {
-                FreePool(BltBuffer);
-                return EFI_INVALID_PARAMETER;
-            }
-            
-            // Convert BGR to RGB
-            BltBuffer[BltIndex].Blue = PixelData[BmpIndex];
-            BltBuffer[BltIndex].Green = PixelData[BmpIndex + 1];
-            BltBuffer[BltIndex].Red = PixelData[BmpIndex + 2];
-            BltBuffer[BltIndex].Reserved = 0;
-        }
+    if (EFI_ERROR(Status)) {
+        return Status;
     }
     
     // Blit entire image in one call (much faster!)
-    Status = uefi_call_wrapper(Gop->Blt, 10, Gop, BltBuffer, EfiBltBufferToVideo,
+    Status = uefi_call_wrapper(Gop->Blt, 10, Gop, Image.Pixels, EfiBltBufferToVideo,
                                0, 0,                    // Source X, Y
                                OffsetX, OffsetY,        // Dest X, Y
-                               Width, Height,           // Width, Height
+                               Image.Width, Image.Height, // Width, Height
                                0);                      // Delta (0 = width * pixel size)
     
-    FreePool(BltBuffer);
+    FreeSplashImage(&Image);
     return Status;
 }
 
@@ -226,7 +401,8 @@ static EFI_STATUS DisplayBMPRowByRow(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
     UINT8 *PixelData = BmpData + FileHeader->OffBits;
     INT32 Width = InfoHeader->Width;
     INT32 Height = InfoHeader->Height;
-    UINTN RowSize = ((Width * 3 + 3) / 4) * 4;
+    UINTN BytesPerPixel = InfoHeader->BitCount / 8;
+    UINTN RowSize = ((Width * BytesPerPixel + 3) / 4) * 4;
     BOOLEAN TopDown = (Height < 0);
     EFI_GRAPHICS_OUTPUT_BLT_PIXEL *RowBuffer;
     EFI_STATUS Status = EFI_SUCCESS;
@@ -234,7 +410,7 @@ static EFI_STATUS DisplayBMPRowByRow(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
     if (TopDown) Height = -Height;
     
     // Allocate buffer for one row
-    RowBuffer = AllocatePool(Width * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    RowBuffer = TrackedAllocatePool(Width * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL), L"BmpRow");
     if (RowBuffer == NULL) {
         return EFI_OUT_OF_RESOURCES;
     }
@@ -246,13 +422,13 @@ static EFI_STATUS DisplayBMPRowByRow(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
             UINTN BmpIndex;
             
             if (TopDown) {
-                BmpIndex = y * RowSize + x * 3;
+                BmpIndex = y * RowSize + x * BytesPerPixel;
             } else {
-                BmpIndex = (Height - 1 - y) * RowSize + x * 3;
+                BmpIndex = (Height - 1 - y) * RowSize + x * BytesPerPixel;
             }
             
             if (BmpIndex + 2 >= BmpSize - FileHeader->OffBits) {
-                FreePool(RowBuffer);
+                TrackedFreePool(RowBuffer);
                 return EFI_INVALID_PARAMETER;
             }
             
@@ -274,6 +450,64 @@ static EFI_STATUS DisplayBMPRowByRow(EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop,
         }
     }
     
-    FreePool(RowBuffer);
+    TrackedFreePool(RowBuffer);
     return Status;
 }
+
+UINTN GetEncodedBMPSize(SPLASH_IMAGE *Image) {
+    UINTN RowSize = ((Image->Width * 3 + 3) / 4) * 4;
+    
+    return sizeof(BMP_FILE_HEADER) + sizeof(BMP_INFO_HEADER) + RowSize * Image->Height;
+}
+
+EFI_STATUS EncodeBMP(SPLASH_IMAGE *Image, UINT8 *Buffer, UINTN BufferSize) {
+    BMP_FILE_HEADER *FileHeader;
+    BMP_INFO_HEADER *InfoHeader;
+    UINTN RowSize;
+    UINT8 *PixelData;
+    
+    if (Image == NULL || Image->Pixels == NULL || Buffer == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    if (BufferSize < GetEncodedBMPSize(Image)) {
+        return EFI_BUFFER_TOO_SMALL;
+    }
+    
+    RowSize = ((Image->Width * 3 + 3) / 4) * 4;
+    
+    FileHeader = (BMP_FILE_HEADER *)Buffer;
+    InfoHeader = (BMP_INFO_HEADER *)(Buffer + sizeof(BMP_FILE_HEADER));
+    PixelData = Buffer + sizeof(BMP_FILE_HEADER) + sizeof(BMP_INFO_HEADER);
+    
+    ZeroMem(Buffer, sizeof(BMP_FILE_HEADER) + sizeof(BMP_INFO_HEADER));
+    FileHeader->Type = 0x4D42;
+    FileHeader->Size = (UINT32)GetEncodedBMPSize(Image);
+    FileHeader->OffBits = sizeof(BMP_FILE_HEADER) + sizeof(BMP_INFO_HEADER);
+    InfoHeader->Size = sizeof(BMP_INFO_HEADER);
+    InfoHeader->Width = (INT32)Image->Width;
+    InfoHeader->Height = (INT32)Image->Height;   // Bottom-up, widest compatibility
+    InfoHeader->Planes = 1;
+    InfoHeader->BitCount = 24;
+    InfoHeader->Compression = BMP_COMPRESSION_RGB;
+    InfoHeader->SizeImage = (UINT32)(RowSize * Image->Height);
+    
+    for (UINT32 y = 0; y < Image->Height; y++) {
+        EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Src = Image->Pixels + (UINTN)y * Image->Width;
+        UINT8 *Dst = PixelData + (UINTN)(Image->Height - 1 - y) * RowSize;
+        UINT32 x;
+        
+        for (x = 0; x < Image->Width; x++) {
+            Dst[x * 3] = Src[x].Blue;
+            Dst[x * 3 + 1] = Src[x].Green;
+            Dst[x * 3 + 2] = Src[x].Red;
+        }
+        
+        // Zero the row padding
+        for (x *= 3; x < RowSize; x++) {
+            Dst[x] = 0;
+        }
+    }
+    
+    return EFI_SUCCESS;
+}
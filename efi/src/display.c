@@ -0,0 +1,508 @@
+#include <efi.h>
+#include <efilib.h>
+#include "display.h"
+#include "alloc.h"
+
+// Nearest-neighbour scale of one destination row into RowBuffer
+static void ScaleRow(SPLASH_IMAGE *Image, SPLASH_DISPLAY *Display,
+                     UINT32 DestY, EFI_GRAPHICS_OUTPUT_BLT_PIXEL *RowBuffer) {
+    // 16.16 fixed-point steps through the source image
+    UINT32 StepX = (UINT32)(((UINT64)Image->Width << 16) / Display->DrawWidth);
+    UINT32 StepY = (UINT32)(((UINT64)Image->Height << 16) / Display->DrawHeight);
+    UINT32 SrcY = (UINT32)(((UINT64)DestY * StepY) >> 16);
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Src = Image->Pixels + (UINTN)SrcY * Image->Width;
+    UINT32 SrcX = 0;
+    
+    for (UINT32 x = 0; x < Display->DrawWidth; x++) {
+        RowBuffer[x] = Src[SrcX >> 16];
+        SrcX += StepX;
+    }
+}
+
+// Rows per band when blending (read-modify-write) or scaling
+#define BLEND_BAND_ROWS 64
+
+// Composite Src over Dst using Src's alpha
+static void BlendPixels(EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Dst,
+                        EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Src, UINT32 Width) {
+    for (UINT32 x = 0; x < Width; x++) {
+        UINT32 Alpha = Src[x].Reserved;
+        UINT32 Inverse = 255 - Alpha;
+        
+        Dst[x].Blue = (UINT8)((Src[x].Blue * Alpha + Dst[x].Blue * Inverse + 127) / 255);
+        Dst[x].Green = (UINT8)((Src[x].Green * Alpha + Dst[x].Green * Inverse + 127) / 255);
+        Dst[x].Red = (UINT8)((Src[x].Red * Alpha + Dst[x].Red * Inverse + 127) / 255);
+    }
+}
+
+// Composite Pixels over what is already on screen using their alpha
+static EFI_STATUS BlendRegion(SPLASH_DISPLAY *Display, EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Pixels,
+                              UINT32 Stride, UINT32 DestX, UINT32 DestY,
+                              UINT32 Width, UINT32 Height) {
+    EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop = Display->Gop;
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Band;
+    UINT32 BandRows = Height < BLEND_BAND_ROWS ? Height : BLEND_BAND_ROWS;
+    EFI_STATUS Status = EFI_SUCCESS;
+    
+    Band = TrackedAllocatePool((UINTN)Width * BandRows * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+                               L"BlendBand");
+    if (Band == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    for (UINT32 Top = 0; Top < Height; Top += BandRows) {
+        UINT32 Rows = (Height - Top < BandRows) ? Height - Top : BandRows;
+        
+        Status = uefi_call_wrapper(Gop->Blt, 10, Gop, Band, EfiBltVideoToBltBuffer,
+                                   DestX, DestY + Top, 0, 0, Width, Rows, 0);
+        if (EFI_ERROR(Status)) {
+            break;
+        }
+        
+        for (UINT32 y = 0; y < Rows; y++) {
+            BlendPixels(Band + (UINTN)y * Width, Pixels + (UINTN)(Top + y) * Stride, Width);
+        }
+        
+        Status = uefi_call_wrapper(Gop->Blt, 10, Gop, Band, EfiBltBufferToVideo,
+                                   0, 0, DestX, DestY + Top, Width, Rows, 0);
+        if (EFI_ERROR(Status)) {
+            break;
+        }
+    }
+    
+    TrackedFreePool(Band);
+    return Status;
+}
+
+// Copy a sub-rectangle of Pixels (Stride pixels per row) to the screen
+static EFI_STATUS BlitRect(SPLASH_DISPLAY *Display, EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Pixels,
+                           UINT32 Stride, UINT32 SourceX, UINT32 SourceY,
+                           UINT32 DestX, UINT32 DestY, UINT32 Width, UINT32 Height) {
+    if (Width == 0 || Height == 0) {
+        return EFI_SUCCESS;
+    }
+    
+    return uefi_call_wrapper(Display->Gop->Blt, 10, Display->Gop, Pixels, EfiBltBufferToVideo,
+                             SourceX, SourceY, DestX, DestY, Width, Height,
+                             Stride * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+}
+
+// Draw Pixels at (DestX, DestY): blended if the image has alpha, otherwise
+// copied around the display's preserved rectangle
+static EFI_STATUS BlitRegion(SPLASH_DISPLAY *Display, BOOLEAN HasAlpha,
+                             EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Pixels, UINT32 Stride,
+                             UINT32 DestX, UINT32 DestY, UINT32 Width, UINT32 Height) {
+    EFI_STATUS Status;
+    UINT32 Left, Top, Right, Bottom;
+    
+    if (HasAlpha) {
+        return BlendRegion(Display, Pixels, Stride, DestX, DestY, Width, Height);
+    }
+    
+    // Intersection of the destination with the preserved rectangle
+    Left = DestX > Display->PreserveX ? DestX : Display->PreserveX;
+    Top = DestY > Display->PreserveY ? DestY : Display->PreserveY;
+    Right = DestX + Width;
+    if (Right > Display->PreserveX + Display->PreserveWidth) {
+        Right = Display->PreserveX + Display->PreserveWidth;
+    }
+    Bottom = DestY + Height;
+    if (Bottom > Display->PreserveY + Display->PreserveHeight) {
+        Bottom = Display->PreserveY + Display->PreserveHeight;
+    }
+    
+    if (!Display->Preserve || Left >= Right || Top >= Bottom) {
+        return BlitRect(Display, Pixels, Stride, 0, 0, DestX, DestY, Width, Height);
+    }
+    
+    // Up to four bands around the hole: above, below, left, right
+    Status = BlitRect(Display, Pixels, Stride, 0, 0,
+                      DestX, DestY, Width, Top - DestY);
+    if (!EFI_ERROR(Status)) {
+        Status = BlitRect(Display, Pixels, Stride, 0, Bottom - DestY,
+                          DestX, Bottom, Width, DestY + Height - Bottom);
+    }
+    if (!EFI_ERROR(Status)) {
+        Status = BlitRect(Display, Pixels, Stride, 0, Top - DestY,
+                          DestX, Top, Left - DestX, Bottom - Top);
+    }
+    if (!EFI_ERROR(Status)) {
+        Status = BlitRect(Display, Pixels, Stride, Right - DestX, Top - DestY,
+                          Right, Top, DestX + Width - Right, Bottom - Top);
+    }
+    
+    return Status;
+}
+
+// Build a full scaled copy for heads that share a resolution
+static EFI_STATUS BuildScaledCache(SPLASH_IMAGE *Image, SPLASH_DISPLAY *Display) {
+    SPLASH_IMAGE *Cache;
+    
+    Cache = TrackedAllocatePool(sizeof(SPLASH_IMAGE), L"ScaledCache");
+    if (Cache == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    Cache->Width = Display->DrawWidth;
+    Cache->Height = Display->DrawHeight;
+    Cache->HasAlpha = Image->HasAlpha;
+    Cache->Pixels = TrackedAllocatePool((UINTN)Cache->Width * Cache->Height *
+                                        sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+                                        L"ScaledPixels");
+    if (Cache->Pixels == NULL) {
+        TrackedFreePool(Cache);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    for (UINT32 y = 0; y < Cache->Height; y++) {
+        ScaleRow(Image, Display, y, Cache->Pixels + (UINTN)y * Cache->Width);
+    }
+    
+    Display->Cache = Cache;
+    Display->OwnsCache = TRUE;
+    return EFI_SUCCESS;
+}
+
+// Scale and blit a band of rows at a time for a head with a unique
+// resolution. Alpha images are blended into the band read back from the
+// screen, so each band costs one read and one write.
+static EFI_STATUS BlitScaledRows(SPLASH_IMAGE *Image, SPLASH_DISPLAY *Display) {
+    EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop = Display->Gop;
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Band;
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL *RowBuffer = NULL;
+    UINT32 Width = Display->DrawWidth;
+    UINT32 BandRows = Display->DrawHeight < BLEND_BAND_ROWS ? Display->DrawHeight : BLEND_BAND_ROWS;
+    EFI_STATUS Status = EFI_SUCCESS;
+    
+    Band = TrackedAllocatePool((UINTN)Width * BandRows * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+                               L"ScaledBand");
+    if (Image->HasAlpha) {
+        RowBuffer = TrackedAllocatePool(Width * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+                                        L"ScaledRow");
+    }
+    if (Band == NULL || (Image->HasAlpha && RowBuffer == NULL)) {
+        TrackedFreePool(Band);
+        TrackedFreePool(RowBuffer);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    for (UINT32 Top = 0; Top < Display->DrawHeight; Top += BandRows) {
+        UINT32 Rows = (Display->DrawHeight - Top < BandRows) ? Display->DrawHeight - Top : BandRows;
+        UINT32 DestY = Display->OffsetY + Top;
+    
+        if (!Image->HasAlpha) {
+            for (UINT32 y = 0; y < Rows; y++) {
+                ScaleRow(Image, Display, Top + y, Band + (UINTN)y * Width);
+            }
+            Status = BlitRegion(Display, FALSE, Band, Width,
+                                Display->OffsetX, DestY, Width, Rows);
+        } else {
+            Status = uefi_call_wrapper(Gop->Blt, 10, Gop, Band, EfiBltVideoToBltBuffer,
+                                       Display->OffsetX, DestY, 0, 0, Width, Rows, 0);
+            if (EFI_ERROR(Status)) {
+                break;
+            }
+    
+            for (UINT32 y = 0; y < Rows; y++) {
+                ScaleRow(Image, Display, Top + y, RowBuffer);
+                BlendPixels(Band + (UINTN)y * Width, RowBuffer, Width);
+            }
+    
+            Status = uefi_call_wrapper(Gop->Blt, 10, Gop, Band, EfiBltBufferToVideo,
+                                       0, 0, Display->OffsetX, DestY, Width, Rows, 0);
+        }
+        if (EFI_ERROR(Status)) {
+            break;
+        }
+    }
+    
+    TrackedFreePool(RowBuffer);
+    TrackedFreePool(Band);
+    return Status;
+}
+
+// TRUE if Path is an instance of the multi-instance List, or a child of
+// one (ConOut may name the graphics controller rather than its output)
+static BOOLEAN DevicePathInList(EFI_DEVICE_PATH *List, EFI_DEVICE_PATH *Path) {
+    UINTN PathSize;
+    
+    if (List == NULL || Path == NULL) {
+        return FALSE;
+    }
+    
+    // Instances are sized without their end node
+    PathSize = DevicePathSize(Path) - sizeof(EFI_DEVICE_PATH);
+    
+    while (List != NULL) {
+        UINTN InstanceSize;
+        EFI_DEVICE_PATH *Instance = DevicePathInstance(&List, &InstanceSize);
+    
+        if (Instance == NULL) {
+            break;
+        }
+        if (InstanceSize > 0 && InstanceSize <= PathSize &&
+            CompareMem(Instance, Path, InstanceSize) == 0) {
+            return TRUE;
+        }
+    }
+    
+    return FALSE;
+}
+
+EFI_STATUS LocateDisplays(SPLASH_DISPLAY *Displays, UINTN MaxDisplays, UINTN *Count) {
+    EFI_STATUS Status;
+    EFI_HANDLE *Handles = NULL;
+    EFI_DEVICE_PATH *ConOut;
+    UINTN HandleCount = 0;
+    UINTN Found = 0;
+    UINTN Console = MaxDisplays;
+    
+    if (Displays == NULL || Count == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    *Count = 0;
+    
+    Status = uefi_call_wrapper(BS->LocateHandleBuffer, 5, ByProtocol,
+                               &gEfiGraphicsOutputProtocolGuid, NULL,
+                               &HandleCount, &Handles);
+    if (EFI_ERROR(Status)) {
+        return Status;
+    }
+    
+    // Device paths of the console outputs, for finding the head firmware
+    // drew its logo on when ConsoleOutHandle is a splitter
+    ConOut = LibGetVariable(L"ConOut", &EfiGlobalVariable);
+    
+    for (UINTN i = 0; i < HandleCount && Found < MaxDisplays; i++) {
+        EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop;
+        EFI_DEVICE_PATH *DevicePath = DevicePathFromHandle(Handles[i]);
+        BOOLEAN Duplicate = FALSE;
+    
+        // A console splitter's GOP is virtual (no device path) and only
+        // mirrors heads that are in ConOut; skip it when physical heads are
+        // available so each is drawn once. ConOut bound straight to a
+        // physical GOP is a real head and is kept.
+        if (HandleCount > 1 && Handles[i] == ST->ConsoleOutHandle && DevicePath == NULL) {
+            continue;
+        }
+    
+        Status = uefi_call_wrapper(BS->HandleProtocol, 3, Handles[i],
+                                   &gEfiGraphicsOutputProtocolGuid, (VOID **)&Gop);
+        if (EFI_ERROR(Status) || Gop->Mode == NULL || Gop->Mode->Info == NULL) {
+            continue;
+        }
+    
+        for (UINTN j = 0; j < Found; j++) {
+            if (Displays[j].Gop == Gop) {
+                Duplicate = TRUE;
+                break;
+            }
+        }
+        if (Duplicate) {
+            continue;
+        }
+    
+        ZeroMem(&Displays[Found], sizeof(SPLASH_DISPLAY));
+        Displays[Found].Gop = Gop;
+        Displays[Found].ScreenWidth = Gop->Mode->Info->HorizontalResolution;
+        Displays[Found].ScreenHeight = Gop->Mode->Info->VerticalResolution;
+    
+        // The console handle itself wins over a ConOut path match
+        if (Handles[i] == ST->ConsoleOutHandle ||
+            (Console == MaxDisplays && DevicePathInList(ConOut, DevicePath))) {
+            Console = Found;
+        }
+        Found++;
+    }
+    
+    // Handle buffer and variable come from firmware, not the tracked allocator
+    FreePool(Handles);
+    if (ConOut != NULL) {
+        FreePool(ConOut);
+    }
+    
+    // Firmware draws its logo on the console head; put that one first
+    if (Console < Found) {
+        SPLASH_DISPLAY First = Displays[0];
+        Displays[0] = Displays[Console];
+        Displays[Console] = First;
+        Displays[0].Console = TRUE;
+    }
+    
+    *Count = Found;
+    return Found > 0 ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+void PlanDisplays(SPLASH_DISPLAY *Displays, UINTN Count,
+                  UINT32 Width, UINT32 Height, SPLASH_ROTATION Rotation) {
+    for (UINTN i = 0; i < Count; i++) {
+        SPLASH_DISPLAY *Display = &Displays[i];
+        UINT32 ScreenWidth = Display->ScreenWidth;
+        UINT32 ScreenHeight = Display->ScreenHeight;
+        UINT32 ImageWidth = Width;
+        UINT32 ImageHeight = Height;
+    
+        Display->Rotation = Rotation;
+        if (Rotation >= SplashRotateCount) {
+            // Portrait-native panels report a portrait mode for a landscape mount
+            BOOLEAN ImagePortrait = Height > Width;
+            BOOLEAN ScreenPortrait = ScreenHeight > ScreenWidth;
+            Display->Rotation = (Width != Height && ScreenWidth != ScreenHeight &&
+                                 ImagePortrait != ScreenPortrait) ?
+                                SPLASH_AUTO_ROTATION : SplashRotate0;
+        }
+    
+        if (Display->Rotation == SplashRotate90 || Display->Rotation == SplashRotate270) {
+            ImageWidth = Height;
+            ImageHeight = Width;
+        }
+    
+        Display->DrawWidth = ImageWidth;
+        Display->DrawHeight = ImageHeight;
+        Display->Scaled = FALSE;
+    
+        // Shrink to fit, preserving aspect ratio; never upscale
+        if (ImageWidth > ScreenWidth || ImageHeight > ScreenHeight) {
+            if ((UINT64)ImageWidth * ScreenHeight > (UINT64)ImageHeight * ScreenWidth) {
+                Display->DrawWidth = ScreenWidth;
+                Display->DrawHeight = (UINT32)((UINT64)ImageHeight * ScreenWidth / ImageWidth);
+            } else {
+                Display->DrawHeight = ScreenHeight;
+                Display->DrawWidth = (UINT32)((UINT64)ImageWidth * ScreenHeight / ImageHeight);
+            }
+    
+            if (Display->DrawWidth == 0) Display->DrawWidth = 1;
+            if (Display->DrawHeight == 0) Display->DrawHeight = 1;
+            Display->Scaled = TRUE;
+        }
+    
+        // Center the image on screen
+        Display->OffsetX = (ScreenWidth - Display->DrawWidth) / 2;
+        Display->OffsetY = (ScreenHeight - Display->DrawHeight) / 2;
+    }
+}
+
+BOOLEAN DisplaysUseRotation(SPLASH_DISPLAY *Displays, UINTN Count,
+                            SPLASH_ROTATION Rotation) {
+    for (UINTN i = 0; i < Count; i++) {
+        if (Displays[i].Rotation == Rotation) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+BOOLEAN PreserveRegion(SPLASH_DISPLAY *Display,
+                       UINT32 X, UINT32 Y, UINT32 Width, UINT32 Height) {
+    if (Width == 0 || Height == 0 ||
+        X + Width > Display->ScreenWidth || Y + Height > Display->ScreenHeight) {
+        return FALSE;
+    }
+    
+    Display->Preserve = TRUE;
+    Display->PreserveX = X;
+    Display->PreserveY = Y;
+    Display->PreserveWidth = Width;
+    Display->PreserveHeight = Height;
+    return TRUE;
+}
+
+EFI_STATUS ClearDisplays(SPLASH_DISPLAY *Displays, UINTN Count) {
+    EFI_STATUS Status;
+    EFI_STATUS Result = EFI_DEVICE_ERROR;
+    EFI_GRAPHICS_OUTPUT_BLT_PIXEL Black = {0, 0, 0, 0};
+    
+    for (UINTN i = 0; i < Count; i++) {
+        // What firmware left around a preserved region stays on screen
+        if (Displays[i].Preserve) {
+            Result = EFI_SUCCESS;
+            continue;
+        }
+        
+        // Clear screen to black
+        Status = uefi_call_wrapper(Displays[i].Gop->Blt, 10, Displays[i].Gop, &Black,
+                                   EfiBltVideoFill,
+                                   0, 0, 0, 0,
+                                   Displays[i].ScreenWidth, Displays[i].ScreenHeight, 0);
+        if (!EFI_ERROR(Status)) {
+            Result = EFI_SUCCESS;
+        }
+    }
+    
+    return Result;
+}
+
+EFI_STATUS RenderToDisplays(SPLASH_DISPLAY *Displays, UINTN Count, SPLASH_IMAGE *Images) {
+    EFI_STATUS Status;
+    EFI_STATUS Result = EFI_DEVICE_ERROR;
+    
+    if (Displays == NULL || Images == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    for (UINTN i = 0; i < Count; i++) {
+        SPLASH_DISPLAY *Display = &Displays[i];
+        SPLASH_IMAGE *Image = &Images[Display->Rotation];
+        SPLASH_IMAGE *Source = Image;
+    
+        if (Image->Pixels == NULL) {
+            continue;
+        }
+    
+        if (Display->Scaled) {
+            // Reuse a scaled copy from an earlier head at the same resolution
+            for (UINTN j = 0; j < i && Display->Cache == NULL; j++) {
+                if (Displays[j].OwnsCache &&
+                    Displays[j].ScreenWidth == Display->ScreenWidth &&
+                    Displays[j].ScreenHeight == Display->ScreenHeight &&
+                    Displays[j].Rotation == Display->Rotation) {
+                    Display->Cache = Displays[j].Cache;
+                }
+            }
+    
+            // Only pay for a full copy when a later head will reuse it
+            if (Display->Cache == NULL) {
+                for (UINTN j = i + 1; j < Count; j++) {
+                    if (Displays[j].ScreenWidth == Display->ScreenWidth &&
+                        Displays[j].ScreenHeight == Display->ScreenHeight &&
+                        Displays[j].Rotation == Display->Rotation) {
+                        BuildScaledCache(Image, Display);
+                        break;
+                    }
+                }
+            }
+    
+            if (Display->Cache == NULL) {
+                Status = BlitScaledRows(Image, Display);
+                if (!EFI_ERROR(Status)) {
+                    Result = EFI_SUCCESS;
+                }
+                continue;
+            }
+    
+            Source = Display->Cache;
+        }
+    
+        // Blit entire image in one call (a few when working around a hole)
+        Status = BlitRegion(Display, Source->HasAlpha, Source->Pixels, Source->Width,
+                            Display->OffsetX, Display->OffsetY,
+                            Source->Width, Source->Height);
+        if (!EFI_ERROR(Status)) {
+            Result = EFI_SUCCESS;
+        }
+    }
+    
+    return Result;
+}
+
+void ReleaseDisplays(SPLASH_DISPLAY *Displays, UINTN Count) {
+    for (UINTN i = 0; i < Count; i++) {
+        if (Displays[i].OwnsCache && Displays[i].Cache != NULL) {
+            FreeSplashImage(Displays[i].Cache);
+            TrackedFreePool(Displays[i].Cache);
+        }
+        Displays[i].Cache = NULL;
+        Displays[i].OwnsCache = FALSE;
+    }
+}
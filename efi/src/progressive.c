@@ -0,0 +1,232 @@
+#include <efi.h>
+#include <efilib.h>
+#include "progressive.h"
+#include "alloc.h"
+
+// Multiple of 3 so samples never straddle a refill
+#define PROGRESSIVE_CHUNK_SIZE (3 * 16384)
+
+// Fill a Width x Height rectangle at (Left, Top)
+static void FillRect(SPLASH_IMAGE *Image, UINT32 Left, UINT32 Top,
+                     UINT32 Width, UINT32 Height, EFI_GRAPHICS_OUTPUT_BLT_PIXEL Pixel) {
+    for (UINT32 y = 0; y < Height; y++) {
+        EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Dst = Image->Pixels + (UINTN)(Top + y) * Image->Width + Left;
+        for (UINT32 x = 0; x < Width; x++) {
+            Dst[x] = Pixel;
+        }
+    }
+}
+
+// Fill the Step x Step block at (X, Y), clipped to the unrotated image,
+// in every requested orientation. A rotated block is still a rectangle;
+// the mapping matches ConvertPixels in bmp.c.
+static void FillBlock(PROGRESSIVE_READER *Reader, UINT32 X, UINT32 Y, UINT32 Step,
+                      EFI_GRAPHICS_OUTPUT_BLT_PIXEL Pixel) {
+    UINT32 Width = Reader->Width;
+    UINT32 Height = Reader->Height;
+    UINT32 BlockWidth = (X + Step > Width) ? Width - X : Step;
+    UINT32 BlockHeight = (Y + Step > Height) ? Height - Y : Step;
+    SPLASH_IMAGE *Images = Reader->Images;
+    
+    if (Images[SplashRotate0].Pixels != NULL) {
+        FillRect(&Images[SplashRotate0], X, Y, BlockWidth, BlockHeight, Pixel);
+    }
+    
+    // (x, y) -> (Height - 1 - y, x)
+    if (Images[SplashRotate90].Pixels != NULL) {
+        FillRect(&Images[SplashRotate90], Height - Y - BlockHeight, X,
+                 BlockHeight, BlockWidth, Pixel);
+    }
+    
+    // (x, y) -> (Width - 1 - x, Height - 1 - y)
+    if (Images[SplashRotate180].Pixels != NULL) {
+        FillRect(&Images[SplashRotate180], Width - X - BlockWidth, Height - Y - BlockHeight,
+                 BlockWidth, BlockHeight, Pixel);
+    }
+    
+    // (x, y) -> (y, Width - 1 - x)
+    if (Images[SplashRotate270].Pixels != NULL) {
+        FillRect(&Images[SplashRotate270], Y, Width - X - BlockWidth,
+                 BlockHeight, BlockWidth, Pixel);
+    }
+}
+
+// Make sure at least one sample is buffered
+static EFI_STATUS RefillChunk(PROGRESSIVE_READER *Reader) {
+    EFI_STATUS Status;
+    UINTN Length = PROGRESSIVE_CHUNK_SIZE;
+    
+    if (Reader->ChunkPosition + 3 <= Reader->ChunkLength) {
+        return EFI_SUCCESS;
+    }
+    
+    Status = uefi_call_wrapper(Reader->File->Read, 3, Reader->File, &Length, Reader->Chunk);
+    if (EFI_ERROR(Status)) {
+        return Status;
+    }
+    
+    // Truncated file
+    if (Length < 3) {
+        return EFI_END_OF_FILE;
+    }
+    
+    Reader->ChunkLength = Length;
+    Reader->ChunkPosition = 0;
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS OpenProgressive(EFI_FILE_PROTOCOL *Root, CHAR16 *FileName,
+                           PROGRESSIVE_READER *Reader) {
+    EFI_STATUS Status;
+    PROGRESSIVE_HEADER Header;
+    UINTN Length = sizeof(Header);
+    
+    if (Root == NULL || FileName == NULL || Reader == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    ZeroMem(Reader, sizeof(PROGRESSIVE_READER));
+    
+    Status = uefi_call_wrapper(Root->Open, 5, Root, &Reader->File, FileName,
+                               EFI_FILE_MODE_READ, 0);
+    if (EFI_ERROR(Status)) {
+        return Status;
+    }
+    
+    // Only the header is read here; pixel data is streamed per pass
+    Status = uefi_call_wrapper(Reader->File->Read, 3, Reader->File, &Length, &Header);
+    if (EFI_ERROR(Status) || Length != sizeof(Header)) {
+        CloseProgressive(Reader);
+        return EFI_ERROR(Status) ? Status : EFI_INVALID_PARAMETER;
+    }
+    
+    if (Header.Signature != PROGRESSIVE_SIGNATURE ||
+        Header.Version != PROGRESSIVE_VERSION ||
+        Header.HeaderSize < sizeof(Header) ||
+        Header.PassCount == 0 || Header.PassCount > PROGRESSIVE_MAX_PASSES ||
+        Header.Width == 0 || Header.Height == 0 ||
+        Header.Width > 8192 || Header.Height > 8192) {
+        CloseProgressive(Reader);
+        return EFI_UNSUPPORTED;
+    }
+    
+    if (Header.HeaderSize != sizeof(Header)) {
+        Status = uefi_call_wrapper(Reader->File->SetPosition, 2, Reader->File,
+                                   (UINT64)Header.HeaderSize);
+        if (EFI_ERROR(Status)) {
+            CloseProgressive(Reader);
+            return Status;
+        }
+    }
+    
+    Reader->Chunk = TrackedAllocatePool(PROGRESSIVE_CHUNK_SIZE, L"ProgressiveChunk");
+    if (Reader->Chunk == NULL) {
+        CloseProgressive(Reader);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    Reader->Width = Header.Width;
+    Reader->Height = Header.Height;
+    Reader->PassCount = Header.PassCount;
+    Reader->Pass = 0;
+    
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS AddProgressiveRotation(PROGRESSIVE_READER *Reader, SPLASH_ROTATION Rotation) {
+    SPLASH_IMAGE *Image;
+    BOOLEAN Transposed = (Rotation == SplashRotate90 || Rotation == SplashRotate270);
+    
+    if (Reader == NULL || Reader->File == NULL || Rotation >= SplashRotateCount ||
+        Reader->Pass != 0) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    Image = &Reader->Images[Rotation];
+    if (Image->Pixels != NULL) {
+        return EFI_SUCCESS;
+    }
+    
+    Image->Pixels = TrackedAllocatePool((UINTN)Reader->Width * Reader->Height *
+                                        sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+                                        L"ProgressiveImage");
+    if (Image->Pixels == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    
+    Image->Width = Transposed ? Reader->Height : Reader->Width;
+    Image->Height = Transposed ? Reader->Width : Reader->Height;
+    Image->HasAlpha = FALSE;
+    
+    return EFI_SUCCESS;
+}
+
+EFI_STATUS ReadProgressivePass(PROGRESSIVE_READER *Reader) {
+    EFI_STATUS Status;
+    UINT32 Step;
+    BOOLEAN FirstPass;
+    
+    if (Reader == NULL || Reader->File == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    if (Reader->Pass >= Reader->PassCount) {
+        return EFI_END_OF_FILE;
+    }
+    
+    Step = 1U << (Reader->PassCount - 1 - Reader->Pass);
+    FirstPass = (Reader->Pass == 0);
+    
+    for (UINT32 y = 0; y < Reader->Height; y += Step) {
+        // Rows on the previous pass's grid already have every other sample
+        BOOLEAN CoarseRow = !FirstPass && (y % (Step * 2)) == 0;
+        UINT32 x = 0;
+        UINT32 Advance = Step;
+        
+        if (CoarseRow) {
+            x = Step;
+            Advance = Step * 2;
+        }
+        
+        for (; x < Reader->Width; x += Advance) {
+            EFI_GRAPHICS_OUTPUT_BLT_PIXEL Pixel;
+            UINT8 *Sample;
+            
+            Status = RefillChunk(Reader);
+            if (EFI_ERROR(Status)) {
+                return Status == EFI_END_OF_FILE ? EFI_INVALID_PARAMETER : Status;
+            }
+            
+            Sample = Reader->Chunk + Reader->ChunkPosition;
+            Reader->ChunkPosition += 3;
+            
+            Pixel.Blue = Sample[0];
+            Pixel.Green = Sample[1];
+            Pixel.Red = Sample[2];
+            Pixel.Reserved = 0;
+            
+            // Upscale the sample over the area it represents at this pass
+            FillBlock(Reader, x, y, Step, Pixel);
+        }
+    }
+    
+    Reader->Pass++;
+    return EFI_SUCCESS;
+}
+
+void CloseProgressive(PROGRESSIVE_READER *Reader) {
+    if (Reader == NULL) {
+        return;
+    }
+    
+    if (Reader->File != NULL) {
+        uefi_call_wrapper(Reader->File->Close, 1, Reader->File);
+        Reader->File = NULL;
+    }
+    
+    TrackedFreePool(Reader->Chunk);
+    Reader->Chunk = NULL;
+    for (UINTN r = 0; r < SplashRotateCount; r++) {
+        FreeSplashImage(&Reader->Images[r]);
+    }
+}
@@ -0,0 +1,65 @@
+#include <efi.h>
+#include <efilib.h>
+#include "record.h"
+
+static EFI_GUID gBootRecordGuid = BOOT_RECORD_GUID;
+
+void InitBootRecord(BOOT_RECORD *Record) {
+    if (Record == NULL) {
+        return;
+    }
+    
+    ZeroMem(Record, sizeof(BOOT_RECORD));
+    Record->Version = BOOT_RECORD_VERSION;
+    Record->Size = sizeof(BOOT_RECORD);
+}
+
+void RecordAllocStats(BOOT_RECORD *Record, ALLOC_STATS *Stats) {
+    if (Record == NULL || Stats == NULL) {
+        return;
+    }
+    
+    Record->MemPeakBytes = Stats->PeakBytes;
+    Record->MemOutstandingBytes = Stats->CurrentBytes;
+    Record->MemAllocationCount = (UINT32)Stats->AllocationCount;
+    Record->MemOutstandingCount = (UINT32)Stats->OutstandingCount;
+    Record->MemRetainedBytes = Stats->RetainedBytes;
+}
+
+void RecordDisplay(BOOT_RECORD *Record, UINTN DisplayCount,
+                   EFI_GRAPHICS_OUTPUT_PROTOCOL *Gop, BOOLEAN RotationForced,
+                   UINT32 AutoRotationDegrees) {
+    if (Record == NULL || Gop == NULL) {
+        return;
+    }
+    
+    Record->DisplayCount = (UINT32)DisplayCount;
+    Record->DisplayWidth = Gop->Mode->Info->HorizontalResolution;
+    Record->DisplayHeight = Gop->Mode->Info->VerticalResolution;
+    Record->PixelFormat = (UINT32)Gop->Mode->Info->PixelFormat;
+    Record->RotationForced = RotationForced ? 1 : 0;
+    Record->AutoRotationDegrees = AutoRotationDegrees;
+}
+
+void RecordSplash(BOOT_RECORD *Record, UINT32 RotationDegrees) {
+    if (Record == NULL) {
+        return;
+    }
+    
+    Record->RotationDegrees = RotationDegrees;
+    Record->SplashDrawn = 1;
+}
+
+EFI_STATUS SaveBootRecord(BOOT_RECORD *Record) {
+    if (Record == NULL) {
+        return EFI_INVALID_PARAMETER;
+    }
+    
+    // Volatile: survives until reset so the OS can read it, but never
+    // touches NVRAM flash on every boot
+    return uefi_call_wrapper(RT->SetVariable, 5, BOOT_RECORD_VARIABLE,
+                             &gBootRecordGuid,
+                             EFI_VARIABLE_BOOTSERVICE_ACCESS |
+                             EFI_VARIABLE_RUNTIME_ACCESS,
+                             sizeof(BOOT_RECORD), Record);
+}
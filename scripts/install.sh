@@ -11,6 +11,8 @@ EFIDIR=${EFIDIR:-/boot/efi/EFI/GhostBSD}
 BOOTDIR=/boot
 RCDIR=${PREFIX}/etc/rc.d
 SBINDIR=${PREFIX}/sbin
+SHAREDIR=${PREFIX}/share/ghostbsd-splash
+LIBEXECDIR=${PREFIX}/libexec/ghostbsd-splash
 
 # Colors for output
 RED='\033[0;31m'
@@ -91,6 +93,17 @@ install_splash_images() {
         # Also install to EFI partition
         cp dist/bmp/splash-1920x1080.bmp "${EFIDIR}/splash.bmp"
         
+        # Progressive copy is preferred by splash.efi when present
+        if [ -f dist/bmp/splash-1920x1080.pgs ]; then
+            cp dist/bmp/splash-1920x1080.pgs "${EFIDIR}/splash.pgs"
+        fi
+        
+        # Source for ghostbsd-select-splash to build an exact-fit splash
+        if [ -f dist/bmp/ghostbsd-logo.png ]; then
+            mkdir -p "${SHAREDIR}"
+            cp dist/bmp/ghostbsd-logo.png "${SHAREDIR}/"
+        fi
+        
         info "Installed splash images to ${BOOTDIR}/splash/"
     else
         warn "No splash images found. Run 'make assets' first."
@@ -113,6 +126,13 @@ install_rc_scripts() {
         chmod 755 "${SBINDIR}/ghostbsd-select-splash"
         info "Installed utility to ${SBINDIR}/"
     fi
+    
+    # Used by ghostbsd-select-splash to build an exact-fit splash.pgs
+    if [ -f dist/libexec/mkprogressive ]; then
+        mkdir -p "${LIBEXECDIR}"
+        cp dist/libexec/mkprogressive "${LIBEXECDIR}/"
+        chmod 755 "${LIBEXECDIR}/mkprogressive"
+    fi
 }
 
 configure_loader() {
@@ -176,6 +196,7 @@ main() {
     echo "  1. Review /boot/loader.conf"
     echo "  2. Reboot to see the splash screen"
     echo "  3. Check /var/log/boot-splash.log for diagnostics"
+    echo "  4. The splash is refitted to the display on the first boot"
     echo ""
     echo "To customize the splash image:"
     echo "  - Edit assets/source/ghostbsd-logo.png"